@@ -0,0 +1,218 @@
+// Cost of the tape models: classic curve vs Jiles-Atherton with RK2 and RK4.
+// Also checks the Langevin function and slope against exact values and exits non-zero if they drift.
+// Console app: links the same JUCE modules as the plugin and the DSP/ sources; the CMake
+// build (PSAT_BUILD_TOOLS) has a target of the same name.
+
+#include <JuceHeader.h>
+#include "../DSP/SaturationProcessor.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numChannels = 2;
+    constexpr int numBlocks = 2000;
+    constexpr int oversamplingRatio = 16; // matches SaturationProcessor's oversampling
+
+    template <typename SampleType>
+    void fillTestSignal(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        // Oversampled buffers are proportionally longer, so scale the rate to keep the same tone
+        const auto bufferRate = sampleRate * buffer.getNumSamples() / blockSize;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            {
+                const auto phase = juce::MathConstants<double>::twoPi * 220.0 * sample / bufferRate;
+                data[sample] = static_cast<SampleType>(0.5 * std::sin(phase) + 0.05 * (random.nextDouble() - 0.5));
+            }
+        }
+    }
+
+    // Returns nanoseconds per input sample (per channel) for the given process callback
+    template <typename SampleType, typename Callback>
+    double measure(int samplesPerBlock, Callback&& processBlock)
+    {
+        juce::AudioBuffer<SampleType> source(numChannels, samplesPerBlock);
+        juce::AudioBuffer<SampleType> work(numChannels, samplesPerBlock);
+        juce::Random random(1234);
+        fillTestSignal(source, random);
+
+        // Warm-up
+        for (int i = 0; i < 50; ++i)
+        {
+            work.makeCopyOf(source, true);
+            juce::dsp::AudioBlock<SampleType> block(work);
+            processBlock(block);
+        }
+
+        double totalSeconds = 0.0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            work.makeCopyOf(source, true);
+            juce::dsp::AudioBlock<SampleType> block(work);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processBlock(block);
+            totalSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        }
+
+        return totalSeconds * 1.0e9 / (static_cast<double>(numBlocks) * blockSize * numChannels);
+    }
+
+    template <typename SampleType>
+    std::vector<std::pair<juce::String, double>> runModels()
+    {
+        const juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+        const char* modelNames[] = { "classic", "hysteresis RK2", "hysteresis RK4" };
+        std::vector<std::pair<juce::String, double>> results;
+
+        // Full saturation stage, oversampling included
+        for (int model = 0; model < 3; ++model)
+        {
+            SaturationProcessor<SampleType> saturation;
+            saturation.prepare(spec);
+            saturation.setDrive(12.0f);
+            saturation.setMix(100.0f);
+            saturation.setSaturationType(1);
+            saturation.setTapeModel(model);
+
+            results.emplace_back(juce::String("stage, ") + modelNames[model], measure<SampleType>(blockSize, [&](auto& block)
+            {
+                saturation.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+            }));
+        }
+
+        // Solver alone, fed an already oversampled block
+        for (auto solver : { JilesAthertonHysteresis<SampleType>::RK2, JilesAthertonHysteresis<SampleType>::RK4 })
+        {
+            JilesAthertonHysteresis<SampleType> hysteresis;
+            hysteresis.prepare(sampleRate * oversamplingRatio, numChannels);
+            hysteresis.setSolver(solver);
+
+            const auto gain = juce::Decibels::decibelsToGain(SampleType(12));
+
+            results.emplace_back(juce::String("solver, ") + modelNames[solver == JilesAthertonHysteresis<SampleType>::RK2 ? 1 : 2],
+                                 measure<SampleType>(blockSize * oversamplingRatio, [&](auto& block)
+            {
+                hysteresis.process(block, gain, SampleType(0));
+            }));
+        }
+
+        return results;
+    }
+
+    struct LangevinError
+    {
+        double value = 0.0, slope = 0.0;
+    };
+
+    // The exact Langevin function and slope in long double. Below |q| = 1 the numerators
+    // q cosh q - sinh q and sinh^2 q - q^2 are summed as series of positive terms, so
+    // nothing cancels; above it coth q - 1/q loses at most a factor of four.
+    void exactLangevin(long double q, long double& value, long double& slope)
+    {
+        const auto sinhQ = std::sinh(q);
+
+        if (std::abs(q) >= 1.0L)
+        {
+            value = 1.0L / std::tanh(q) - 1.0L / q;
+            slope = 1.0L / (q * q) - 1.0L / (sinhQ * sinhQ);
+            return;
+        }
+
+        const auto q2 = q * q;
+        long double valueTerm = q, valueNumerator = 0.0L;
+        long double slopeTerm = 1.0L, slopeNumerator = 0.0L;
+
+        for (int n = 1; n < 30; ++n)
+        {
+            // q^(2n+1) (1/(2n)! - 1/(2n+1)!) and (2q)^(2n) / (2 (2n)!), the latter from n = 2
+            valueTerm *= q2 / ((2.0L * n) * (2.0L * n + 1.0L));
+            valueNumerator += valueTerm * (2.0L * n);
+
+            slopeTerm *= 4.0L * q2 / ((2.0L * n - 1.0L) * (2.0L * n));
+            slopeNumerator += n >= 2 ? slopeTerm / 2.0L : 0.0L;
+        }
+
+        value = valueNumerator / (q * sinhQ);
+        slope = slopeNumerator / (q2 * sinhQ * sinhQ);
+    }
+
+    // Worst relative error of the Langevin function and its slope against the exact values,
+    // swept logarithmically over both signs of q from 1e-6 to 100
+    template <typename SampleType>
+    LangevinError measureLangevinPrecision()
+    {
+        LangevinError worst;
+
+        for (int step = 0; step <= 8000; ++step)
+        {
+            const auto magnitude = static_cast<SampleType>(std::pow(10.0, -6.0 + 8.0 * step / 8000.0));
+
+            for (const auto q : { magnitude, -magnitude })
+            {
+                SampleType value, slope;
+                long double exactValue, exactSlope;
+                JilesAthertonHysteresis<SampleType>::langevin(q, value, slope);
+                exactLangevin(static_cast<long double>(q), exactValue, exactSlope);
+
+                worst.value = juce::jmax(worst.value, static_cast<double>(std::abs((value - exactValue) / exactValue)));
+                worst.slope = juce::jmax(worst.slope, static_cast<double>(std::abs((slope - exactSlope) / exactSlope)));
+            }
+        }
+
+        return worst;
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    const auto floatResults = runModels<float>();
+    const auto doubleResults = runModels<double>();
+
+    // One core spends 1e9 ns per second; a stereo instance needs sampleRate * numChannels samples per second
+    const auto instancesPerCore = [](double nsPerSample)
+    {
+        return nsPerSample > 0.0 ? 1.0e9 / (nsPerSample * sampleRate * numChannels) : 0.0;
+    };
+
+    std::printf("%-24s %12s %12s %14s\n", "tape model", "float ns/smp", "double ns/smp", "stereo/core");
+
+    for (size_t i = 0; i < floatResults.size(); ++i)
+    {
+        const auto floatCost = floatResults[i].second;
+        const auto doubleCost = doubleResults[i].second;
+
+        std::printf("%-24s %12.2f %12.2f %14.1f\n", floatResults[i].first.toRawUTF8(),
+                    floatCost, doubleCost, instancesPerCore(floatCost));
+    }
+
+    // The slope feeds dM/dH directly, so it must match the exact function across the whole
+    // range of q; near zero coth(q) - 1/q cancels and only the series keeps it accurate
+    constexpr double floatTolerance = 2.0e-6;
+    constexpr double doubleTolerance = 1.0e-12;
+    const auto floatError = measureLangevinPrecision<float>();
+    const auto doubleError = measureLangevinPrecision<double>();
+
+    std::printf("\nLangevin vs exact, float:  value %.2e, slope %.2e (tolerance %.0e)\n",
+                floatError.value, floatError.slope, floatTolerance);
+    std::printf("Langevin vs exact, double: value %.2e, slope %.2e (tolerance %.0e)\n",
+                doubleError.value, doubleError.slope, doubleTolerance);
+
+    if (juce::jmax(floatError.value, floatError.slope) > floatTolerance
+        || juce::jmax(doubleError.value, doubleError.slope) > doubleTolerance)
+    {
+        std::fprintf(stderr, "Langevin precision exceeds the tolerance\n");
+        return 1;
+    }
+
+    return 0;
+}
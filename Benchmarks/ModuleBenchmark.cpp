@@ -0,0 +1,287 @@
+// Headless micro-benchmark of every DSP module across block sizes and sample rates.
+// Console app: links the same JUCE modules as the plugin and the DSP/ sources; the CMake
+// build (PSAT_BUILD_TOOLS) has a target of the same name.
+//
+// Writes one JSON document so results can be archived and compared between releases:
+//   ModuleBenchmark [--output results.json] [--filter Saturation] [--precision float|double|both] [--seconds 0.5]
+
+#include <JuceHeader.h>
+#include "../DSP/ProcessingChain.h"
+
+namespace
+{
+    constexpr int numChannels = 2;
+    constexpr int warmUpBlocks = 8;
+    constexpr int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    constexpr double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    const char* const saturationTypeNames[] = { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz" };
+
+    struct Options
+    {
+        juce::String filter;
+        juce::File outputFile;
+        bool runFloat = true;
+        bool runDouble = false;
+        double secondsPerCase = 0.5;
+    };
+
+    struct Case
+    {
+        double sampleRate;
+        int blockSize;
+    };
+
+    template <typename SampleType>
+    void fillTestSignal(juce::AudioBuffer<SampleType>& buffer, double sampleRate, juce::Random& random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            // A slow sweep with a little noise, so adaptive modules keep moving
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            {
+                const auto time = sample / sampleRate;
+                const auto phase = juce::MathConstants<double>::twoPi * (110.0 * time + 400.0 * time * time);
+                data[sample] = static_cast<SampleType>(0.5 * std::sin(phase) + 0.05 * (random.nextDouble() - 0.5));
+            }
+        }
+    }
+
+    // Runs the module over secondsPerCase of audio in consecutive blocks.
+    // Returns nanoseconds per sample (per channel) and the realtime factor.
+    template <typename SampleType, typename Callback>
+    std::pair<double, double> measure(const Case& benchCase, double secondsPerCase, Callback&& processBlock)
+    {
+        const auto numBlocks = juce::jmax(warmUpBlocks, static_cast<int>(secondsPerCase * benchCase.sampleRate / benchCase.blockSize));
+        const auto totalSamples = numBlocks * benchCase.blockSize;
+
+        juce::AudioBuffer<SampleType> signal(numChannels, totalSamples);
+        juce::Random random(1234);
+        fillTestSignal(signal, benchCase.sampleRate, random);
+
+        juce::dsp::AudioBlock<SampleType> signalBlock(signal);
+
+        // Warm-up runs over the start of the signal, which is regenerated afterwards
+        for (int i = 0; i < warmUpBlocks; ++i)
+        {
+            auto block = signalBlock.getSubBlock(static_cast<size_t>(i * benchCase.blockSize), static_cast<size_t>(benchCase.blockSize));
+            processBlock(block);
+        }
+
+        fillTestSignal(signal, benchCase.sampleRate, random);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            auto block = signalBlock.getSubBlock(static_cast<size_t>(i * benchCase.blockSize), static_cast<size_t>(benchCase.blockSize));
+            processBlock(block);
+        }
+
+        const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        const auto audioSeconds = totalSamples / benchCase.sampleRate;
+
+        return { seconds * 1.0e9 / (static_cast<double>(totalSamples) * numChannels),
+                 seconds > 0.0 ? audioSeconds / seconds : 0.0 };
+    }
+
+    class Report
+    {
+    public:
+        explicit Report(const Options& optionsToUse) : options(optionsToUse) {}
+
+        bool wants(const juce::String& module, const juce::String& variant) const
+        {
+            return options.filter.isEmpty() || (module + " " + variant).containsIgnoreCase(options.filter);
+        }
+
+        void add(const juce::String& module, const juce::String& variant, const char* precision,
+                 const Case& benchCase, std::pair<double, double> result)
+        {
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("module", module);
+            entry->setProperty("variant", variant);
+            entry->setProperty("precision", precision);
+            entry->setProperty("sampleRate", benchCase.sampleRate);
+            entry->setProperty("blockSize", benchCase.blockSize);
+            entry->setProperty("nsPerSample", result.first);
+            entry->setProperty("realtimeFactor", result.second);
+            results.add(juce::var(entry));
+
+            // Progress goes to stderr so stdout stays valid JSON
+            std::fprintf(stderr, "%-20s %-24s %-6s %8.0f Hz %5d  %10.2f ns/smp  %10.1fx\n",
+                         module.toRawUTF8(), variant.toRawUTF8(), precision, benchCase.sampleRate,
+                         benchCase.blockSize, result.first, result.second);
+        }
+
+        juce::String toJSON() const
+        {
+            auto* root = new juce::DynamicObject();
+            root->setProperty("benchmark", "ModuleBenchmark");
+            root->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+            root->setProperty("cpu", juce::SystemStats::getCpuModel());
+            root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+            root->setProperty("numChannels", numChannels);
+            root->setProperty("secondsPerCase", options.secondsPerCase);
+            root->setProperty("results", results);
+
+            return juce::JSON::toString(juce::var(root));
+        }
+
+    private:
+        const Options& options;
+        juce::Array<juce::var> results;
+    };
+
+    template <typename SampleType>
+    void runModules(Report& report, const Options& options, const char* precision)
+    {
+        for (const auto sampleRate : sampleRates)
+        {
+            for (const auto blockSize : blockSizes)
+            {
+                const Case benchCase { sampleRate, blockSize };
+                const juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+
+                // Saturation: every analogue type at every oversampling factor
+                for (int type = 0; type < 5; ++type)
+                {
+                    for (int order = 0; order <= SaturationProcessor<SampleType>::defaultOversamplingOrder; ++order)
+                    {
+                        const auto variant = juce::String(saturationTypeNames[type]) + ", " + juce::String(1 << order) + "x";
+
+                        if (! report.wants("SaturationProcessor", variant))
+                            continue;
+
+                        SaturationProcessor<SampleType> saturation;
+                        saturation.setOversamplingOrder(order);
+                        saturation.prepare(spec);
+                        saturation.setDrive(12.0f);
+                        saturation.setMix(100.0f);
+                        saturation.setSaturationType(type);
+
+                        report.add("SaturationProcessor", variant, precision, benchCase,
+                                   measure<SampleType>(benchCase, options.secondsPerCase, [&](auto& block)
+                        {
+                            saturation.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+                        }));
+                    }
+                }
+
+                if (report.wants("AdaptiveEqualizer", "Musical"))
+                {
+                    AdaptiveEqualizer<SampleType> equalizer;
+                    equalizer.prepare(spec);
+                    equalizer.setEnabled(true);
+                    equalizer.setTargetCurve(AdaptiveEqualizer<SampleType>::Musical);
+
+                    report.add("AdaptiveEqualizer", "Musical", precision, benchCase,
+                               measure<SampleType>(benchCase, options.secondsPerCase, [&](auto& block)
+                    {
+                        equalizer.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+                    }));
+                }
+
+                if (report.wants("LinearPhaseFilters", "80 Hz - 12 kHz"))
+                {
+                    LinearPhaseFilters<SampleType> filters;
+                    filters.prepare(spec);
+                    filters.setEnabled(true);
+                    filters.setLowCutFrequency(80.0f);
+                    filters.setHighCutFrequency(12000.0f);
+
+                    report.add("LinearPhaseFilters", "80 Hz - 12 kHz", precision, benchCase,
+                               measure<SampleType>(benchCase, options.secondsPerCase, [&](auto& block)
+                    {
+                        filters.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+                    }));
+                }
+
+                if (report.wants("FFTProcessor", "analysis"))
+                {
+                    FFTProcessor fft;
+                    fft.prepare(spec);
+
+                    report.add("FFTProcessor", "analysis", precision, benchCase,
+                               measure<SampleType>(benchCase, options.secondsPerCase, [&](auto& block)
+                    {
+                        const auto& spectrum = fft.getSpectrum(juce::dsp::AudioBlock<const SampleType>(block));
+                        juce::ignoreUnused(spectrum);
+                    }));
+                }
+
+                if (report.wants("LoudnessCompensator", "with meters"))
+                {
+                    LevelMeter<SampleType> inputMeter, outputMeter;
+                    LoudnessCompensator<SampleType> compensator;
+                    inputMeter.prepare(spec);
+                    outputMeter.prepare(spec);
+                    compensator.prepare(spec);
+
+                    report.add("LoudnessCompensator", "with meters", precision, benchCase,
+                               measure<SampleType>(benchCase, options.secondsPerCase, [&](auto& block)
+                    {
+                        inputMeter.process(block);
+                        compensator.analyzeInput(inputMeter);
+                        outputMeter.process(block);
+                        compensator.analyzeOutput(outputMeter);
+                        compensator.applyCompensation(block);
+                    }));
+                }
+            }
+        }
+    }
+
+    Options parseOptions(const juce::ArgumentList& arguments)
+    {
+        Options options;
+
+        if (arguments.containsOption("--output"))
+            options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--output"));
+
+        if (arguments.containsOption("--filter"))
+            options.filter = arguments.getValueForOption("--filter");
+
+        if (arguments.containsOption("--seconds"))
+            options.secondsPerCase = juce::jmax(0.01, arguments.getValueForOption("--seconds").getDoubleValue());
+
+        if (arguments.containsOption("--precision"))
+        {
+            const auto precision = arguments.getValueForOption("--precision");
+            options.runFloat = precision != "double";
+            options.runDouble = precision == "double" || precision == "both";
+        }
+
+        return options;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    const auto options = parseOptions(juce::ArgumentList(argc, argv));
+    Report report(options);
+
+    if (options.runFloat)
+        runModules<float>(report, options, "float");
+
+    if (options.runDouble)
+        runModules<double>(report, options, "double");
+
+    const auto json = report.toJSON();
+
+    if (options.outputFile == juce::File())
+    {
+        std::printf("%s\n", json.toRawUTF8());
+    }
+    else if (! options.outputFile.replaceWithText(json))
+    {
+        std::fprintf(stderr, "Could not write %s\n", options.outputFile.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+// Float vs double cost per DSP module.
+// Console app: links the same JUCE modules as the plugin and the DSP/ sources; the CMake
+// build (PSAT_BUILD_TOOLS) has a target of the same name.
+
+#include <JuceHeader.h>
+#include "../DSP/ProcessingChain.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numChannels = 2;
+    constexpr int numBlocks = 2000;
+
+    template <typename SampleType>
+    void fillTestSignal(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            {
+                const auto phase = juce::MathConstants<double>::twoPi * 220.0 * sample / sampleRate;
+                data[sample] = static_cast<SampleType>(0.5 * std::sin(phase) + 0.05 * (random.nextDouble() - 0.5));
+            }
+        }
+    }
+
+    // Returns nanoseconds per sample (per channel) for the given process callback
+    template <typename SampleType, typename Callback>
+    double measure(Callback&& processBlock)
+    {
+        juce::AudioBuffer<SampleType> source(numChannels, blockSize);
+        juce::AudioBuffer<SampleType> work(numChannels, blockSize);
+        juce::Random random(1234);
+        fillTestSignal(source, random);
+
+        // Warm-up
+        for (int i = 0; i < 50; ++i)
+        {
+            work.makeCopyOf(source, true);
+            juce::dsp::AudioBlock<SampleType> block(work);
+            processBlock(block);
+        }
+
+        double totalSeconds = 0.0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            work.makeCopyOf(source, true);
+            juce::dsp::AudioBlock<SampleType> block(work);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processBlock(block);
+            totalSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        }
+
+        return totalSeconds * 1.0e9 / (static_cast<double>(numBlocks) * blockSize * numChannels);
+    }
+
+    template <typename SampleType>
+    std::vector<std::pair<juce::String, double>> runModules()
+    {
+        const juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+        std::vector<std::pair<juce::String, double>> results;
+
+        for (int type = 0; type < 5; ++type)
+        {
+            SaturationProcessor<SampleType> saturation;
+            saturation.prepare(spec);
+            saturation.setDrive(12.0f);
+            saturation.setMix(100.0f);
+            saturation.setSaturationType(type);
+
+            results.emplace_back("SaturationProcessor type " + juce::String(type), measure<SampleType>([&](auto& block)
+            {
+                saturation.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+            }));
+        }
+
+        {
+            AdaptiveEqualizer<SampleType> equalizer;
+            equalizer.prepare(spec);
+            equalizer.setEnabled(true);
+            equalizer.setTargetCurve(AdaptiveEqualizer<SampleType>::Musical);
+
+            results.emplace_back("AdaptiveEqualizer", measure<SampleType>([&](auto& block)
+            {
+                equalizer.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+            }));
+        }
+
+        {
+            LinearPhaseFilters<SampleType> filters;
+            filters.prepare(spec);
+            filters.setEnabled(true);
+            filters.setLowCutFrequency(80.0f);
+            filters.setHighCutFrequency(12000.0f);
+
+            results.emplace_back("LinearPhaseFilters", measure<SampleType>([&](auto& block)
+            {
+                filters.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+            }));
+        }
+
+        {
+            LevelMeter<SampleType> inputMeter, outputMeter;
+            LoudnessCompensator<SampleType> compensator;
+            inputMeter.prepare(spec);
+            outputMeter.prepare(spec);
+            compensator.prepare(spec);
+
+            results.emplace_back("LoudnessCompensator", measure<SampleType>([&](auto& block)
+            {
+                inputMeter.process(block);
+                compensator.analyzeInput(inputMeter);
+                outputMeter.process(block);
+                compensator.analyzeOutput(outputMeter);
+                compensator.applyCompensation(block);
+            }));
+        }
+
+        return results;
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    const auto floatResults = runModules<float>();
+    const auto doubleResults = runModules<double>();
+
+    std::printf("%-28s %12s %12s %8s\n", "module", "float ns/smp", "double ns/smp", "ratio");
+
+    for (size_t i = 0; i < floatResults.size(); ++i)
+    {
+        const auto floatCost = floatResults[i].second;
+        const auto doubleCost = doubleResults[i].second;
+
+        std::printf("%-28s %12.2f %12.2f %8.2f\n", floatResults[i].first.toRawUTF8(),
+                    floatCost, doubleCost, floatCost > 0.0 ? doubleCost / floatCost : 0.0);
+    }
+
+    return 0;
+}
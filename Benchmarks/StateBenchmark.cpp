@@ -0,0 +1,138 @@
+// Session save/load cost per plugin instance: the binary state against the XML state
+// of earlier releases, which setStateInformation() still reads.
+// Console app: build with the plugin sources (PluginProcessor, PluginEditor,
+// Components/, DSP/, LookAndFeel/, StateFormat), the same JUCE modules and JucePlugin_* defines;
+// the CMake build (PSAT_BUILD_TOOLS) has a target of the same name.
+//
+//   StateBenchmark [--instances 200] [--iterations 10]
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+namespace
+{
+    struct Instance
+    {
+        std::unique_ptr<ProfessionalSaturationAudioProcessor> processor;
+
+        // Two different states, so every load actually changes parameters
+        std::array<juce::MemoryBlock, 2> binaryStates;
+        std::array<juce::MemoryBlock, 2> xmlStates;
+    };
+
+    void randomiseParameters(juce::AudioProcessor& processor, juce::Random& random)
+    {
+        for (auto* parameter : processor.getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    // What getStateInformation() wrote before the binary format
+    void writeXmlState(ProfessionalSaturationAudioProcessor& processor, juce::MemoryBlock& destData)
+    {
+        auto state = processor.getValueTreeState().copyState();
+        std::unique_ptr<juce::XmlElement> xml(state.createXml());
+        juce::AudioProcessor::copyXmlToBinary(*xml, destData);
+    }
+
+    std::vector<float> getParameterValues(juce::AudioProcessor& processor)
+    {
+        std::vector<float> values;
+
+        for (auto* parameter : processor.getParameters())
+            values.push_back(parameter->getValue());
+
+        return values;
+    }
+
+    // Microseconds per instance for one pass of callback over all instances, best of iterations
+    template <typename Callback>
+    double measure(std::vector<Instance>& instances, int iterations, Callback&& callback)
+    {
+        auto best = std::numeric_limits<double>::max();
+
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (auto& instance : instances)
+                callback(instance, iteration);
+
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            best = juce::jmin(best, seconds * 1.0e6 / static_cast<double>(instances.size()));
+        }
+
+        return best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList arguments(argc, argv);
+    const auto numInstances = juce::jmax(1, arguments.containsOption("--instances") ? arguments.getValueForOption("--instances").getIntValue() : 200);
+    const auto iterations = juce::jmax(1, arguments.containsOption("--iterations") ? arguments.getValueForOption("--iterations").getIntValue() : 10);
+
+    std::vector<Instance> instances(static_cast<size_t>(numInstances));
+    juce::Random random(42);
+
+    for (auto& instance : instances)
+    {
+        instance.processor = std::make_unique<ProfessionalSaturationAudioProcessor>();
+
+        for (size_t state = 0; state < 2; ++state)
+        {
+            randomiseParameters(*instance.processor, random);
+            instance.processor->getStateInformation(instance.binaryStates[state]);
+            writeXmlState(*instance.processor, instance.xmlStates[state]);
+        }
+    }
+
+    // Both formats must restore the same values before their timings mean anything
+    for (auto& instance : instances)
+    {
+        auto& processor = *instance.processor;
+        processor.setStateInformation(instance.xmlStates[0].getData(), static_cast<int>(instance.xmlStates[0].getSize()));
+        const auto fromXml = getParameterValues(processor);
+
+        processor.setStateInformation(instance.binaryStates[1].getData(), static_cast<int>(instance.binaryStates[1].getSize()));
+        processor.setStateInformation(instance.binaryStates[0].getData(), static_cast<int>(instance.binaryStates[0].getSize()));
+
+        if (getParameterValues(processor) != fromXml)
+        {
+            std::fprintf(stderr, "Binary state does not restore the same parameters as the XML state\n");
+            return 1;
+        }
+    }
+
+    juce::MemoryBlock scratch;
+
+    const auto xmlSave = measure(instances, iterations, [&](Instance& instance, int)
+    {
+        writeXmlState(*instance.processor, scratch);
+    });
+
+    const auto binarySave = measure(instances, iterations, [&](Instance& instance, int)
+    {
+        instance.processor->getStateInformation(scratch);
+    });
+
+    const auto xmlLoad = measure(instances, iterations, [](Instance& instance, int iteration)
+    {
+        const auto& state = instance.xmlStates[static_cast<size_t>(iteration % 2)];
+        instance.processor->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    });
+
+    const auto binaryLoad = measure(instances, iterations, [](Instance& instance, int iteration)
+    {
+        const auto& state = instance.binaryStates[static_cast<size_t>(iteration % 2)];
+        instance.processor->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    });
+
+    std::printf("%d instances, best of %d passes, microseconds per instance\n\n", numInstances, iterations);
+    std::printf("%-8s %10s %10s %10s\n", "Format", "Save", "Load", "Bytes");
+    std::printf("%-8s %10.2f %10.2f %10d\n", "XML", xmlSave, xmlLoad, static_cast<int>(instances.front().xmlStates[0].getSize()));
+    std::printf("%-8s %10.2f %10.2f %10d\n", "Binary", binarySave, binaryLoad, static_cast<int>(instances.front().binaryStates[0].getSize()));
+    std::printf("\nSpeed-up: save %.1fx, load %.1fx\n", xmlSave / binarySave, xmlLoad / binaryLoad);
+    return 0;
+}
@@ -1,6 +1,6 @@
 #include "EqualizerDisplay.h"
 
-EqualizerDisplay::EqualizerDisplay(AdaptiveEqualizer& eq) : equalizer(eq)
+EqualizerDisplay::EqualizerDisplay(ProfessionalSaturationAudioProcessor& processor) : audioProcessor(processor)
 {
     startTimer(100); // 10 FPS update rate
 }
@@ -44,14 +44,21 @@ void EqualizerDisplay::resized()
 
 void EqualizerDisplay::timerCallback()
 {
+    const Trace::ScopedEvent trace("EQ display timer");
+    
     // Update data from equalizer
-    currentResponse = equalizer.getFrequencyResponse();
-    currentSpectrum = equalizer.getCurrentSpectrum();
-    targetCurve = equalizer.getTargetCurve();
+    currentResponse = audioProcessor.getEqualizerFrequencyResponse();
+    currentSpectrum = audioProcessor.getEqualizerSpectrum();
+    targetCurve = audioProcessor.getEqualizerTargetCurve();
     
     repaint();
 }
 
+size_t EqualizerDisplay::getMemoryUsage() const
+{
+    return MemoryFootprint::bytesOf(currentResponse) + MemoryFootprint::bytesOf(currentSpectrum) + MemoryFootprint::bytesOf(targetCurve);
+}
+
 void EqualizerDisplay::drawFrequencyGrid(juce::Graphics& g, juce::Rectangle<int> bounds)
 {
     g.setColour(CustomLookAndFeel::secondaryColor.withAlpha(0.3f));
@@ -1,18 +1,21 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "../DSP/AdaptiveEqualizer.h"
+#include "../PluginProcessor.h"
 #include "../LookAndFeel/CustomLookAndFeel.h"
 
 class EqualizerDisplay : public juce::Component, public juce::Timer
 {
 public:
-    EqualizerDisplay(AdaptiveEqualizer& eq);
+    EqualizerDisplay(ProfessionalSaturationAudioProcessor& processor);
     ~EqualizerDisplay() override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
     void timerCallback() override;
+    
+    // Heap memory of the cached curves, in bytes
+    size_t getMemoryUsage() const;
 
 private:
     void drawFrequencyResponse(juce::Graphics& g, juce::Rectangle<int> bounds);
@@ -20,7 +23,7 @@ private:
     void drawSpectrum(juce::Graphics& g, juce::Rectangle<int> bounds);
     void drawTargetCurve(juce::Graphics& g, juce::Rectangle<int> bounds);
     
-    AdaptiveEqualizer& equalizer;
+    ProfessionalSaturationAudioProcessor& audioProcessor;
     
     std::vector<float> currentResponse;
     std::vector<float> currentSpectrum;
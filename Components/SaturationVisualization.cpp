@@ -1,8 +1,8 @@
 #include "SaturationVisualization.h"
 #include "../Parameters.h"
 
-SaturationVisualization::SaturationVisualization(SaturationProcessor& processor, juce::AudioProcessorValueTreeState& vts)
-    : saturationProcessor(processor), valueTreeState(vts)
+SaturationVisualization::SaturationVisualization(ProfessionalSaturationAudioProcessor& processor, juce::AudioProcessorValueTreeState& vts)
+    : audioProcessor(processor), valueTreeState(vts)
 {
     driveParameter = valueTreeState.getRawParameterValue(ParameterIDs::drive);
     satTypeParameter = valueTreeState.getRawParameterValue(ParameterIDs::satType);
@@ -103,7 +103,7 @@ void SaturationVisualization::drawSaturationCurve(juce::Graphics& g, juce::Recta
     for (int i = 0; i <= curveResolution; ++i)
     {
         float input = juce::jmap(static_cast<float>(i), 0.0f, static_cast<float>(curveResolution), -inputRange, inputRange);
-        float output = saturationProcessor.getSaturationCurveValue(input);
+        float output = audioProcessor.getSaturationCurveValue(input);
         
         // Map to screen coordinates
         float x = juce::jmap(input, -inputRange, inputRange, static_cast<float>(bounds.getX()), static_cast<float>(bounds.getRight()));
@@ -169,7 +169,7 @@ void SaturationVisualization::drawLabels(juce::Graphics& g, juce::Rectangle<int>
     if (satTypeParameter)
     {
         int satType = static_cast<int>(satTypeParameter->load());
-        std::vector<juce::String> typeNames = { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz" };
+        std::vector<juce::String> typeNames = { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz", "Neural Model" };
         
         if (satType >= 0 && satType < static_cast<int>(typeNames.size()))
         {
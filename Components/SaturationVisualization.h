@@ -1,13 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "../DSP/SaturationProcessor.h"
+#include "../PluginProcessor.h"
 #include "../LookAndFeel/CustomLookAndFeel.h"
 
 class SaturationVisualization : public juce::Component, public juce::Timer
 {
 public:
-    SaturationVisualization(SaturationProcessor& processor, juce::AudioProcessorValueTreeState& vts);
+    SaturationVisualization(ProfessionalSaturationAudioProcessor& processor, juce::AudioProcessorValueTreeState& vts);
     ~SaturationVisualization() override;
 
     void paint(juce::Graphics& g) override;
@@ -20,7 +20,7 @@ private:
     void drawLabels(juce::Graphics& g, juce::Rectangle<int> bounds);
     void drawInputOutputLine(juce::Graphics& g, juce::Rectangle<int> bounds);
     
-    SaturationProcessor& saturationProcessor;
+    ProfessionalSaturationAudioProcessor& audioProcessor;
     juce::AudioProcessorValueTreeState& valueTreeState;
     
     std::atomic<float>* driveParameter = nullptr;
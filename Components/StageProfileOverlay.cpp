@@ -0,0 +1,138 @@
+#include "StageProfileOverlay.h"
+
+void StageProfileOverlay::setFrame(const MeterFrame& frame)
+{
+    averageLoad = frame.stageAverageLoad;
+    worstLoad = frame.stageWorstLoad;
+    worstBlockLoad = frame.worstBlockLoad;
+    profiling = frame.stageProfilingEnabled;
+    repaint();
+}
+
+void StageProfileOverlay::setDeadlineSummary(const DeadlineMonitor::Summary& summary)
+{
+    deadlines = summary;
+    repaint();
+}
+
+void StageProfileOverlay::setMemoryFootprint(const MemoryFootprint& footprint)
+{
+    memoryBytes = footprint.getTotalBytes();
+    repaint();
+}
+
+void StageProfileOverlay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds();
+    
+    // Translucent so the display underneath stays recognisable
+    g.setColour(CustomLookAndFeel::primaryColor.darker(0.5f).withAlpha(0.92f));
+    g.fillRect(bounds);
+    
+    g.setColour(CustomLookAndFeel::secondaryColor);
+    g.drawRect(bounds, 1);
+    
+    bounds.reduce(8, 6);
+    
+    g.setColour(CustomLookAndFeel::accentColor);
+    g.setFont(juce::FontOptions().withHeight(11.0f).withStyle("bold"));
+    g.drawText("CPU PER STAGE  (avg / worst, % of real time)", bounds.removeFromTop(16), juce::Justification::centredLeft);
+    
+    if (!profiling)
+    {
+        g.setColour(CustomLookAndFeel::textColor);
+        g.setFont(juce::FontOptions().withHeight(10.0f));
+        g.drawText("Waiting for audio...", bounds, juce::Justification::centred);
+        return;
+    }
+    
+    bounds.removeFromTop(4);
+    paintDeadlines(g, bounds.removeFromBottom(34));
+    bounds.removeFromBottom(4);
+    
+    if (memoryBytes > 0)
+    {
+        g.setColour(CustomLookAndFeel::textColor);
+        g.setFont(juce::FontOptions().withHeight(10.0f));
+        g.drawText("Memory held by this instance: " + MemoryFootprint::formatBytes(memoryBytes),
+                   bounds.removeFromBottom(14), juce::Justification::centredLeft);
+    }
+    
+    const auto rowHeight = bounds.getHeight() / (StageProfile::numStages + 1);
+    float totalAverage = 0.0f;
+    
+    for (int stage = 0; stage < StageProfile::numStages; ++stage)
+    {
+        const auto index = static_cast<size_t>(stage);
+        paintRow(g, bounds.removeFromTop(rowHeight), StageProfile::getStageName(stage), averageLoad[index], worstLoad[index], false);
+        totalAverage += averageLoad[index];
+    }
+    
+    paintRow(g, bounds.removeFromTop(rowHeight), "Total", totalAverage, worstBlockLoad, true);
+}
+
+void StageProfileOverlay::paintRow(juce::Graphics& g, juce::Rectangle<int> bounds, const juce::String& name, float average, float worst, bool emphasised)
+{
+    auto nameArea = bounds.removeFromLeft(juce::jmin(90, bounds.getWidth() / 3));
+    auto valueArea = bounds.removeFromRight(juce::jmin(90, bounds.getWidth() / 2));
+    auto barArea = bounds.reduced(4, juce::jmax(1, bounds.getHeight() / 4)).toFloat();
+    
+    const auto font = juce::FontOptions().withHeight(10.0f).withStyle(emphasised ? "bold" : "plain");
+    g.setFont(font);
+    g.setColour(CustomLookAndFeel::textColor);
+    g.drawText(name, nameArea, juce::Justification::centredLeft);
+    g.drawText(juce::String(average, 2) + " / " + juce::String(worst, 2), valueArea, juce::Justification::centredRight);
+    
+    // Average as a bar, worst case as a tick; overloads past full scale turn the bar red
+    g.setColour(CustomLookAndFeel::backgroundColor);
+    g.fillRect(barArea);
+    
+    const auto toWidth = [&barArea](float load) { return barArea.getWidth() * juce::jlimit(0.0f, 1.0f, load / fullScaleLoad); };
+    
+    g.setColour(average > fullScaleLoad ? CustomLookAndFeel::warningColor : CustomLookAndFeel::successColor);
+    g.fillRect(barArea.withWidth(toWidth(average)));
+    
+    g.setColour(CustomLookAndFeel::warningColor);
+    g.fillRect(barArea.getX() + toWidth(worst) - 1.0f, barArea.getY(), 2.0f, barArea.getHeight());
+}
+
+void StageProfileOverlay::paintDeadlines(juce::Graphics& g, juce::Rectangle<int> bounds)
+{
+    g.setColour(CustomLookAndFeel::secondaryColor);
+    g.drawHorizontalLine(bounds.getY(), static_cast<float>(bounds.getX()), static_cast<float>(bounds.getRight()));
+    bounds.removeFromTop(3);
+    
+    // Load histogram since the plugin was loaded; log scale so rare long-tail blocks stay visible
+    auto histogramArea = bounds.removeFromRight(juce::jmin(130, bounds.getWidth() / 3)).reduced(2).toFloat();
+    const auto barWidth = histogramArea.getWidth() / static_cast<float>(DeadlineMonitor::numBuckets);
+    const auto maxCount = std::log1p(static_cast<float>(*std::max_element(deadlines.histogram.begin(), deadlines.histogram.end())));
+    
+    g.setColour(CustomLookAndFeel::backgroundColor);
+    g.fillRect(histogramArea);
+    
+    for (int bucket = 0; bucket < DeadlineMonitor::numBuckets; ++bucket)
+    {
+        const auto count = std::log1p(static_cast<float>(deadlines.histogram[static_cast<size_t>(bucket)]));
+        const auto height = maxCount > 0.0f ? histogramArea.getHeight() * count / maxCount : 0.0f;
+        
+        g.setColour(bucket >= 10 ? CustomLookAndFeel::warningColor : CustomLookAndFeel::successColor);
+        g.fillRect(histogramArea.getX() + bucket * barWidth + 0.5f, histogramArea.getBottom() - height, barWidth - 1.0f, height);
+    }
+    
+    const auto misses = static_cast<juce::int64>(deadlines.numDeadlineMisses);
+    
+    g.setFont(juce::FontOptions().withHeight(10.0f).withStyle(misses > 0 ? "bold" : "plain"));
+    g.setColour(misses > 0 ? CustomLookAndFeel::warningColor : CustomLookAndFeel::textColor);
+    g.drawText("Deadline misses: " + juce::String(misses)
+                   + "   Outliers (>" + juce::String(static_cast<int>(DeadlineMonitor::outlierLoadPercent)) + "%): "
+                   + juce::String(static_cast<juce::int64>(deadlines.numOutliers))
+                   + "   Worst: " + juce::String(deadlines.worstLoadPercent, 1) + "%",
+               bounds.removeFromTop(bounds.getHeight() / 2), juce::Justification::centredLeft);
+    
+    g.setFont(juce::FontOptions().withHeight(10.0f));
+    g.setColour(CustomLookAndFeel::textColor);
+    g.drawText("Late callbacks: " + juce::String(static_cast<juce::int64>(deadlines.numLateCallbacks))
+                   + "   Worst lateness: " + juce::String(deadlines.worstLateMilliseconds, 2) + " ms"
+                   + "   Blocks: " + juce::String(static_cast<juce::int64>(deadlines.numBlocks)),
+               bounds, juce::Justification::centredLeft);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/MeterSnapshot.h"
+#include "../DSP/DeadlineMonitor.h"
+#include "../DSP/MemoryFootprint.h"
+#include "../LookAndFeel/CustomLookAndFeel.h"
+
+// Diagnostics panel: CPU load of each chain stage, averaged and worst case,
+// in percent of the real-time budget, above a footer with the deadline statistics.
+// Fed with meter frames, deadline summaries and the memory footprint by the editor.
+class StageProfileOverlay : public juce::Component
+{
+public:
+    StageProfileOverlay() = default;
+    ~StageProfileOverlay() override = default;
+
+    void paint(juce::Graphics& g) override;
+    
+    void setFrame(const MeterFrame& frame);
+    void setDeadlineSummary(const DeadlineMonitor::Summary& summary);
+    void setMemoryFootprint(const MemoryFootprint& footprint);
+
+private:
+    void paintRow(juce::Graphics& g, juce::Rectangle<int> bounds, const juce::String& name, float average, float worst, bool emphasised);
+    void paintDeadlines(juce::Graphics& g, juce::Rectangle<int> bounds);
+    
+    std::array<float, StageProfile::numStages> averageLoad {};
+    std::array<float, StageProfile::numStages> worstLoad {};
+    float worstBlockLoad = 0.0f;
+    bool profiling = false;
+    DeadlineMonitor::Summary deadlines;
+    size_t memoryBytes = 0;
+    
+    // Bars span 0 .. fullScaleLoad percent of one core
+    static constexpr float fullScaleLoad = 50.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StageProfileOverlay)
+};
@@ -1,7 +1,7 @@
 #include "VUMeter.h"
 
-VUMeter::VUMeter(MeterType type, SaturationProcessor* satProcessor, LoudnessCompensator* compensator)
-    : meterType(type), saturationProcessor(satProcessor), loudnessCompensator(compensator)
+VUMeter::VUMeter(MeterType type, const MeterSnapshot* snapshot)
+    : meterType(type), meterSnapshot(snapshot)
 {
     startTimer(1000 / updateRate);
 }
@@ -39,15 +39,16 @@ void VUMeter::paint(juce::Graphics& g)
     
     bounds.removeFromRight(3);
     
-    // Split into left and right channels
-    auto leftBounds = bounds.removeFromLeft(bounds.getWidth() / 2);
-    auto rightBounds = bounds;
+    // Split evenly into one bar per channel
+    const auto channelWidth = bounds.getWidth() / static_cast<int>(numChannels);
     
-    leftBounds.removeFromRight(1);
-    rightBounds.removeFromLeft(1);
-    
-    paintChannel(g, leftBounds, rmsLevels[0], peakLevels[0], "L");
-    paintChannel(g, rightBounds, rmsLevels[1], peakLevels[1], "R");
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto channelBounds = channel + 1 < numChannels ? bounds.removeFromLeft(channelWidth) : bounds;
+        channelBounds.reduce(1, 0);
+        
+        paintChannel(g, channelBounds, channel);
+    }
 }
 
 void VUMeter::resized()
@@ -57,27 +58,28 @@ void VUMeter::resized()
 
 void VUMeter::timerCallback()
 {
-    if (meterType == Input && saturationProcessor)
+    if (meterType == Input && meterSnapshot && meterSnapshot->read(lastFrame))
     {
-        float newRMS[2], newPeak[2];
-        for (int channel = 0; channel < 2; ++channel)
+        const auto numFrameChannels = juce::jmin(numChannels, static_cast<size_t>(lastFrame.numChannels));
+        
+        for (size_t channel = 0; channel < numFrameChannels; ++channel)
         {
-            newRMS[channel] = saturationProcessor->getRMSLevel(channel);
-            newPeak[channel] = saturationProcessor->getPeakLevel(channel);
+            const float newRMS = lastFrame.saturationRMS[channel];
+            const float newPeak = lastFrame.saturationPeak[channel];
             
             // Smooth RMS
-            rmsLevels[channel] = rmsLevels[channel] * smoothingFactor + newRMS[channel] * (1.0f - smoothingFactor);
+            rmsLevels[channel] = rmsLevels[channel] * smoothingFactor + newRMS * (1.0f - smoothingFactor);
             
             // Peak with hold
-            if (newPeak[channel] > peakLevels[channel])
+            if (newPeak > peakLevels[channel])
             {
-                peakLevels[channel] = newPeak[channel];
-                peakHold[channel] = newPeak[channel];
+                peakLevels[channel] = newPeak;
+                peakHold[channel] = newPeak;
                 peakHoldTimer[channel] = peakHoldTime;
             }
             else
             {
-                peakLevels[channel] = peakLevels[channel] * 0.95f + newPeak[channel] * 0.05f;
+                peakLevels[channel] = peakLevels[channel] * 0.95f + newPeak * 0.05f;
                 
                 if (peakHoldTimer[channel] > 0)
                 {
@@ -90,25 +92,45 @@ void VUMeter::timerCallback()
             }
         }
     }
-    else if (meterType == Output && loudnessCompensator)
+    repaint();
+}
+
+void VUMeter::setLevels(const float* rms, const float* peak, size_t numChannelsToShow)
+{
+    for (size_t channel = 0; channel < juce::jmin(numChannels, numChannelsToShow); ++channel)
     {
-        // For output meter, we could show compensated levels
-        // This would need to be implemented in the main processor
+        rmsLevels[channel] = rms[channel];
+        peakLevels[channel] = peak[channel];
     }
-    
-    repaint();
 }
 
-void VUMeter::setLevels(float rmsLeft, float rmsRight, float peakLeft, float peakRight)
+void VUMeter::setChannelLayout(const juce::AudioChannelSet& layout)
 {
-    rmsLevels[0] = rmsLeft;
-    rmsLevels[1] = rmsRight;
-    peakLevels[0] = peakLeft;
-    peakLevels[1] = peakRight;
+    numChannels = static_cast<size_t>(juce::jlimit(1, static_cast<int>(MeterFrame::maxChannels), layout.size()));
+    
+    channelLabels.clear();
+    for (int channel = 0; channel < static_cast<int>(numChannels); ++channel)
+    {
+        if (layout.size() == 1)
+            channelLabels.add("M");
+        else
+            channelLabels.add(juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(channel)));
+    }
+    
+    std::fill(rmsLevels.begin(), rmsLevels.end(), 0.0f);
+    std::fill(peakLevels.begin(), peakLevels.end(), 0.0f);
+    std::fill(peakHold.begin(), peakHold.end(), 0.0f);
+    std::fill(peakHoldTimer.begin(), peakHoldTimer.end(), 0);
+    
+    repaint();
 }
 
-void VUMeter::paintChannel(juce::Graphics& g, juce::Rectangle<int> bounds, float rmsLevel, float peakLevel, const juce::String& label)
+void VUMeter::paintChannel(juce::Graphics& g, juce::Rectangle<int> bounds, size_t channel)
 {
+    const float rmsLevel = rmsLevels[channel];
+    const float peakLevel = peakLevels[channel];
+    const auto& label = channelLabels[static_cast<int>(channel)];
+    
     auto meterBounds = bounds.reduced(2).toFloat();
     
     // Convert levels to dB
@@ -159,8 +181,7 @@ void VUMeter::paintChannel(juce::Graphics& g, juce::Rectangle<int> bounds, float
     }
     
     // Peak hold indicator
-    int currentChannel = (label == "L") ? 0 : 1;
-    float holdDb = juce::Decibels::gainToDecibels(peakHold[currentChannel], minDb);
+    float holdDb = juce::Decibels::gainToDecibels(peakHold[channel], minDb);
     float holdNormalized = juce::jmap(holdDb, minDb, maxDb, 0.0f, 1.0f);
     holdNormalized = juce::jlimit(0.0f, 1.0f, holdNormalized);
     
@@ -182,7 +203,10 @@ void VUMeter::paintChannel(juce::Graphics& g, juce::Rectangle<int> bounds, float
     g.setFont(juce::FontOptions().withHeight(9.0f).withStyle("bold"));
     g.drawText(label, bounds.removeFromBottom(12), juce::Justification::centred);
     
-    // dB value display
+    // dB value display, skipped when the bars get too narrow (surround layouts)
+    if (bounds.getWidth() < 24)
+        return;
+    
     juce::String dbText = juce::String(rmsDb, 1) + "dB";
     g.setFont(juce::FontOptions().withHeight(8.0f));
     g.drawText(dbText, bounds.removeFromBottom(10), juce::Justification::centred);
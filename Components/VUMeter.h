@@ -1,8 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "../DSP/SaturationProcessor.h"
-#include "../DSP/LoudnessCompensator.h"
+#include "../DSP/MeterSnapshot.h"
 #include "../LookAndFeel/CustomLookAndFeel.h"
 
 class VUMeter : public juce::Component, public juce::Timer
@@ -14,27 +13,32 @@ public:
         Output
     };
 
-    VUMeter(MeterType type, SaturationProcessor* satProcessor = nullptr, LoudnessCompensator* compensator = nullptr);
+    VUMeter(MeterType type, const MeterSnapshot* snapshot = nullptr);
     ~VUMeter() override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
     void timerCallback() override;
     
-    void setLevels(float rmsLeft, float rmsRight, float peakLeft, float peakRight);
+    void setLevels(const float* rms, const float* peak, size_t numChannelsToShow);
+    void setChannelLayout(const juce::AudioChannelSet& layout);
 
 private:
-    void paintChannel(juce::Graphics& g, juce::Rectangle<int> bounds, float rmsLevel, float peakLevel, const juce::String& label);
+    void paintChannel(juce::Graphics& g, juce::Rectangle<int> bounds, size_t channel);
     void paintScale(juce::Graphics& g, juce::Rectangle<int> bounds);
     
     MeterType meterType;
-    SaturationProcessor* saturationProcessor;
-    LoudnessCompensator* loudnessCompensator;
+    const MeterSnapshot* meterSnapshot;
+    MeterFrame lastFrame;
     
-    float rmsLevels[2] = { 0.0f, 0.0f };
-    float peakLevels[2] = { 0.0f, 0.0f };
-    float peakHold[2] = { 0.0f, 0.0f };
-    int peakHoldTimer[2] = { 0, 0 };
+    // One bar per channel of the bus layout, up to MeterFrame::maxChannels
+    size_t numChannels = 2;
+    juce::StringArray channelLabels { "L", "R" };
+    
+    std::array<float, MeterFrame::maxChannels> rmsLevels {};
+    std::array<float, MeterFrame::maxChannels> peakLevels {};
+    std::array<float, MeterFrame::maxChannels> peakHold {};
+    std::array<int, MeterFrame::maxChannels> peakHoldTimer {};
     
     static constexpr float smoothingFactor = 0.8f;
     static constexpr int updateRate = 60; // Hz
@@ -1,6 +1,9 @@
 #include "AdaptiveEqualizer.h"
+#include "MemoryFootprint.h"
+#include "TraceRecorder.h"
 
-AdaptiveEqualizer::AdaptiveEqualizer()
+template <typename SampleType>
+AdaptiveEqualizer<SampleType>::AdaptiveEqualizer()
 {
     targetCurveValues.resize(8, 0.0f);
     currentSpectrum.resize(8, 0.0f);
@@ -16,7 +19,8 @@ AdaptiveEqualizer::AdaptiveEqualizer()
     }
 }
 
-void AdaptiveEqualizer::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
 {
     currentSpec = spec;
     sampleRate = static_cast<float>(spec.sampleRate);
@@ -38,8 +42,9 @@ void AdaptiveEqualizer::prepare(const juce::dsp::ProcessSpec& spec)
         auto& band = bands[i];
         
         // Create bell filter coefficients
-        band.coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            sampleRate, band.frequency, 2.0f, juce::Decibels::decibelsToGain(band.gain));
+        band.coefficients = juce::dsp::IIR::Coefficients<SampleType>::makePeakFilter(
+            sampleRate, static_cast<SampleType>(band.frequency), SampleType(2),
+            juce::Decibels::decibelsToGain(static_cast<SampleType>(band.gain)));
         
         // Apply coefficients to all processing chains
         for (auto& chain : processingChains)
@@ -62,7 +67,8 @@ void AdaptiveEqualizer::prepare(const juce::dsp::ProcessSpec& spec)
     reset();
 }
 
-void AdaptiveEqualizer::reset()
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::reset()
 {
     fftProcessor.reset();
     
@@ -76,28 +82,40 @@ void AdaptiveEqualizer::reset()
     
     for (auto& band : bands)
     {
-        band.gain = 0.0f;
+        band.targetGain = 0.0f;
         band.smoothedGain = 0.0f;
     }
+    
+    // Bring the filters back to flat along with the gains
+    updateFilterCoefficients();
 }
 
-void AdaptiveEqualizer::setEnabled(bool isEnabled)
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::setEnabled(bool isEnabled)
 {
     enabled = isEnabled;
 }
 
-void AdaptiveEqualizer::setTargetCurve(int curve)
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::setTargetCurve(int curve)
 {
-    targetCurveType = juce::jlimit(0, 4, curve);
+    curve = juce::jlimit(0, 4, curve);
+    
+    if (curve == targetCurveType)
+        return;
+    
+    targetCurveType = curve;
     updateTargetCurve();
 }
 
-void AdaptiveEqualizer::setAdaptionStrength(float strength)
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::setAdaptionStrength(float strength)
 {
     adaptionStrength = juce::jlimit(0.0f, 1.0f, strength / 100.0f);
 }
 
-void AdaptiveEqualizer::setReactionSpeed(float speedMs)
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::setReactionSpeed(float speedMs)
 {
     reactionSpeed = juce::jlimit(10.0f, 1000.0f, speedMs);
     
@@ -107,7 +125,8 @@ void AdaptiveEqualizer::setReactionSpeed(float speedMs)
     smoothingCoeff = std::exp(-1.0f / (timeConstant * sampleRate / 1024.0f)); // Assuming 1024 sample analysis blocks
 }
 
-void AdaptiveEqualizer::updateTargetCurve()
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::updateTargetCurve()
 {
     switch (targetCurveType)
     {
@@ -137,10 +156,14 @@ void AdaptiveEqualizer::updateTargetCurve()
     }
 }
 
-void AdaptiveEqualizer::analyzeSpectrum(const juce::dsp::AudioBlock<const float>& block)
+template <typename SampleType>
+bool AdaptiveEqualizer<SampleType>::analyzeSpectrum(const juce::dsp::AudioBlock<const SampleType>& block)
 {
     // Get FFT analysis
-    auto spectrum = fftProcessor.getSpectrum(block);
+    const auto& spectrum = fftProcessor.getSpectrum(block);
+    
+    if (!fftProcessor.hasNewSpectrum())
+        return false;
     
     // Map FFT bins to our 8 bands
     for (size_t i = 0; i < bands.size(); ++i)
@@ -157,9 +180,12 @@ void AdaptiveEqualizer::analyzeSpectrum(const juce::dsp::AudioBlock<const float>
         smoothedSpectrum[i] = smoothedSpectrum[i] * smoothingCoeff + magnitudeDb * (1.0f - smoothingCoeff);
         currentSpectrum[i] = magnitudeDb;
     }
+    
+    return true;
 }
 
-void AdaptiveEqualizer::updateBandGains()
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::updateBandGains()
 {
     for (size_t i = 0; i < bands.size(); ++i)
     {
@@ -177,42 +203,47 @@ void AdaptiveEqualizer::updateBandGains()
         // Smooth the gain changes
         band.targetGain = correction;
         band.smoothedGain = band.smoothedGain * 0.95f + band.targetGain * 0.05f;
-        band.gain = band.smoothedGain;
     }
 }
 
-void AdaptiveEqualizer::updateFilterCoefficients()
+template <typename SampleType>
+void AdaptiveEqualizer<SampleType>::updateFilterCoefficients()
 {
     for (size_t i = 0; i < bands.size(); ++i)
     {
         auto& band = bands[i];
         
-        // Update coefficients only if gain changed significantly
-        if (std::abs(band.gain - band.smoothedGain) > 0.1f)
+        // Update coefficients only if the gain moved significantly since they were built
+        if (band.coefficients != nullptr && std::abs(band.gain - band.smoothedGain) > 0.1f)
         {
-            band.coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-                sampleRate, band.frequency, 2.0f, juce::Decibels::decibelsToGain(band.gain));
+            band.gain = band.smoothedGain;
             
-            // Apply to all processing chains
-            for (auto& chain : processingChains)
-            {
-                switch (i)
-                {
-                    case 0: chain.template get<0>().coefficients = band.coefficients; break;
-                    case 1: chain.template get<1>().coefficients = band.coefficients; break;
-                    case 2: chain.template get<2>().coefficients = band.coefficients; break;
-                    case 3: chain.template get<3>().coefficients = band.coefficients; break;
-                    case 4: chain.template get<4>().coefficients = band.coefficients; break;
-                    case 5: chain.template get<5>().coefficients = band.coefficients; break;
-                    case 6: chain.template get<6>().coefficients = band.coefficients; break;
-                    case 7: chain.template get<7>().coefficients = band.coefficients; break;
-                }
-            }
+            // Every chain shares the band's coefficient object from prepare(), so
+            // overwriting it in place updates them all without allocating
+            *band.coefficients = juce::dsp::IIR::ArrayCoefficients<SampleType>::makePeakFilter(
+                sampleRate, static_cast<SampleType>(band.frequency), SampleType(2),
+                juce::Decibels::decibelsToGain(static_cast<SampleType>(band.gain)));
+            Trace::instant("EQ coefficient swap", static_cast<juce::int64>(i));
         }
     }
 }
 
-std::vector<float> AdaptiveEqualizer::getFrequencyResponse() const
+template <typename SampleType>
+int AdaptiveEqualizer<SampleType>::getTailLengthSamples() const
+{
+    if (!enabled)
+        return 0;
+    
+    // A bell rings with time constant 2Q / w0; the lowest band decays slowest. Allow 120 dB of decay.
+    constexpr double q = 2.0;
+    constexpr double decayTimeConstants = 13.8;
+    const auto timeConstant = 2.0 * q / (juce::MathConstants<double>::twoPi * static_cast<double>(bandFrequencies.front()));
+    
+    return static_cast<int>(std::ceil(decayTimeConstants * timeConstant * static_cast<double>(sampleRate)));
+}
+
+template <typename SampleType>
+std::vector<float> AdaptiveEqualizer<SampleType>::getFrequencyResponse() const
 {
     std::vector<float> response(bands.size());
     for (size_t i = 0; i < bands.size(); ++i)
@@ -222,12 +253,24 @@ std::vector<float> AdaptiveEqualizer::getFrequencyResponse() const
     return response;
 }
 
-std::vector<float> AdaptiveEqualizer::getTargetCurve() const
+template <typename SampleType>
+std::vector<float> AdaptiveEqualizer<SampleType>::getTargetCurve() const
 {
     return targetCurveValues;
 }
 
-std::vector<float> AdaptiveEqualizer::getCurrentSpectrum() const
+template <typename SampleType>
+std::vector<float> AdaptiveEqualizer<SampleType>::getCurrentSpectrum() const
 {
     return currentSpectrum;
 }
+
+template <typename SampleType>
+size_t AdaptiveEqualizer<SampleType>::getMemoryUsage() const
+{
+    return fftProcessor.getMemoryUsage() + MemoryFootprint::bytesOf(targetCurveValues) + MemoryFootprint::bytesOf(currentSpectrum)
+         + MemoryFootprint::bytesOf(smoothedSpectrum) + MemoryFootprint::bytesOf(processingChains);
+}
+
+template class AdaptiveEqualizer<float>;
+template class AdaptiveEqualizer<double>;
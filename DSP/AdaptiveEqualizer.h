@@ -3,6 +3,7 @@
 #include <JuceHeader.h>
 #include "FFTProcessor.h"
 
+template <typename SampleType>
 class AdaptiveEqualizer
 {
 public:
@@ -32,20 +33,26 @@ public:
     std::vector<float> getFrequencyResponse() const;
     std::vector<float> getTargetCurve() const;
     std::vector<float> getCurrentSpectrum() const;
+    
+    // Samples until the band filters have rung out after the input falls silent
+    int getTailLengthSamples() const;
+    
+    // Heap memory allocated by prepare(), in bytes (see MemoryFootprint)
+    size_t getMemoryUsage() const;
 
 private:
     struct Band
     {
         float frequency;
-        float gain;
+        float gain;         // what the filter coefficients were last built with
         float targetGain;
         float smoothedGain;
-        juce::dsp::IIR::Filter<float> filter;
-        juce::dsp::IIR::Coefficients<float>::Ptr coefficients;
+        juce::dsp::IIR::Filter<SampleType> filter;
+        typename juce::dsp::IIR::Coefficients<SampleType>::Ptr coefficients;
     };
     
     void updateTargetCurve();
-    void analyzeSpectrum(const juce::dsp::AudioBlock<const float>& block);
+    bool analyzeSpectrum(const juce::dsp::AudioBlock<const SampleType>& block);
     void updateBandGains();
     void updateFilterCoefficients();
     
@@ -71,21 +78,22 @@ private:
     
     // Processing chains for each channel
     std::vector<juce::dsp::ProcessorChain<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>
+        juce::dsp::IIR::Filter<SampleType>,
+        juce::dsp::IIR::Filter<SampleType>,
+        juce::dsp::IIR::Filter<SampleType>,
+        juce::dsp::IIR::Filter<SampleType>,
+        juce::dsp::IIR::Filter<SampleType>,
+        juce::dsp::IIR::Filter<SampleType>,
+        juce::dsp::IIR::Filter<SampleType>,
+        juce::dsp::IIR::Filter<SampleType>
     >> processingChains;
     
     juce::dsp::ProcessSpec currentSpec;
 };
 
-template<typename ProcessContext>
-void AdaptiveEqualizer::process(const ProcessContext& context)
+template <typename SampleType>
+template <typename ProcessContext>
+void AdaptiveEqualizer<SampleType>::process(const ProcessContext& context)
 {
     if (!enabled)
         return;
@@ -93,14 +101,15 @@ void AdaptiveEqualizer::process(const ProcessContext& context)
     auto& inputBlock = context.getInputBlock();
     auto& outputBlock = context.getOutputBlock();
     
-    // Analyze spectrum for adaptation
-    analyzeSpectrum(inputBlock);
-    
-    // Update band gains based on analysis
-    updateBandGains();
-    
-    // Update filter coefficients
-    updateFilterCoefficients();
+    // Analyze spectrum for adaptation; gains only move when a new FFT frame arrives
+    if (analyzeSpectrum(inputBlock))
+    {
+        // Update band gains based on analysis
+        updateBandGains();
+        
+        // Update filter coefficients
+        updateFilterCoefficients();
+    }
     
     // Process each channel through the filter chain
     for (size_t channel = 0; channel < inputBlock.getNumChannels(); ++channel)
@@ -108,7 +117,7 @@ void AdaptiveEqualizer::process(const ProcessContext& context)
         if (channel < processingChains.size())
         {
             auto channelBlock = outputBlock.getSingleChannelBlock(channel);
-            juce::dsp::ProcessContextReplacing<float> channelContext(channelBlock);
+            juce::dsp::ProcessContextReplacing<SampleType> channelContext(channelBlock);
             processingChains[channel].process(channelContext);
         }
     }
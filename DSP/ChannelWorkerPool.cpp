@@ -0,0 +1,170 @@
+#include "ChannelWorkerPool.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+ChannelWorkerPool::~ChannelWorkerPool()
+{
+    release();
+}
+
+void ChannelWorkerPool::prepare(int numWorkers, double sampleRate, int maximumBlockSize, const juce::AudioWorkgroup& workgroup)
+{
+    release();
+    
+    // Leave one core for the host's own audio thread
+    const auto numCores = juce::SystemStats::getNumCpus();
+    numWorkers = juce::jlimit(0, juce::jmax(0, numCores - 1), numWorkers);
+    
+    const auto options = juce::Thread::RealtimeOptions {}
+                             .withApproximateAudioProcessingTime(juce::jmax(1, maximumBlockSize), sampleRate > 0.0 ? sampleRate : 44100.0);
+    
+    for (int index = 0; index < numWorkers; ++index)
+    {
+        auto worker = std::make_unique<Worker>(*this, index, workgroup);
+        
+        // A worker that cannot get real-time scheduling would only slow the callback down
+        if (!worker->startRealtimeThread(options))
+            break;
+        
+        workers.push_back(std::move(worker));
+    }
+    
+    starvedDispatches = 0;
+    serialBlocksRemaining = 0;
+}
+
+void ChannelWorkerPool::release()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+    
+    for (auto& worker : workers)
+    {
+        worker->wakeEvent.signal();
+        worker->stopThread(1000);
+    }
+    
+    workers.clear();
+}
+
+void ChannelWorkerPool::runTasks(int numTasks, TaskFunction function, void* context) noexcept
+{
+    if (workers.empty() || numTasks <= 1 || serialBlocksRemaining > 0)
+    {
+        if (serialBlocksRemaining > 0)
+            --serialBlocksRemaining;
+        
+        for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+            function(context, taskIndex);
+        
+        return;
+    }
+    
+    // Publish the job; nextTask is reset last so a worker that claims a task sees the new job
+    taskFunction.store(function, std::memory_order_relaxed);
+    taskContext.store(context, std::memory_order_relaxed);
+    taskCount.store(numTasks, std::memory_order_relaxed);
+    tasksFinished.store(0, std::memory_order_relaxed);
+    tasksRunByWorkers.store(0, std::memory_order_relaxed);
+    nextTask.store(0, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_seq_cst);
+    
+    for (auto& worker : workers)
+    {
+        if (worker->parked.load(std::memory_order_seq_cst))
+        {
+            // Waking a parked worker takes the event's lock briefly; accepted by design
+            const RealtimeSafety::ScopedPermit wakePermit;
+            worker->wakeEvent.signal();
+        }
+    }
+    
+    // Work alongside the pool, then wait for tasks still running on workers
+    claimAndRunTasks(false);
+    
+    while (tasksFinished.load(std::memory_order_acquire) < numTasks)
+        spinPause();
+    
+    // If the workers never got a task, the host is keeping every core busy
+    if (tasksRunByWorkers.load(std::memory_order_relaxed) == 0)
+    {
+        if (++starvedDispatches >= starvedDispatchLimit)
+        {
+            starvedDispatches = 0;
+            serialBlocksRemaining = serialBackoffBlocks;
+        }
+    }
+    else
+    {
+        starvedDispatches = 0;
+    }
+}
+
+void ChannelWorkerPool::claimAndRunTasks(bool onWorker) noexcept
+{
+    for (;;)
+    {
+        const auto taskIndex = nextTask.fetch_add(1, std::memory_order_acq_rel);
+        
+        if (taskIndex >= taskCount.load(std::memory_order_relaxed))
+            break;
+        
+        taskFunction.load(std::memory_order_relaxed)(taskContext.load(std::memory_order_relaxed), taskIndex);
+        
+        // Counted before finishing so the dispatcher sees it once it has joined
+        if (onWorker)
+            tasksRunByWorkers.fetch_add(1, std::memory_order_relaxed);
+        
+        tasksFinished.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void ChannelWorkerPool::spinPause() noexcept
+{
+   #if JUCE_INTEL
+    _mm_pause();
+   #endif
+}
+
+ChannelWorkerPool::Worker::Worker(ChannelWorkerPool& owner, int index, const juce::AudioWorkgroup& workgroupToJoin)
+    : juce::Thread("Channel worker " + juce::String(index)), pool(owner), workgroup(workgroupToJoin)
+{
+}
+
+void ChannelWorkerPool::Worker::run()
+{
+    // Held for the thread's lifetime; leaves the workgroup when it goes out of scope
+    juce::WorkgroupToken workgroupToken;
+    
+    if (workgroup)
+        workgroup.join(workgroupToken);
+    
+    auto seenGeneration = pool.generation.load(std::memory_order_acquire);
+    
+    while (!threadShouldExit())
+    {
+        // Spin briefly in case the next dispatch follows closely (small host blocks)
+        for (int spin = 0; spin < spinIterations && pool.generation.load(std::memory_order_acquire) == seenGeneration; ++spin)
+            spinPause();
+        
+        if (pool.generation.load(std::memory_order_acquire) == seenGeneration)
+        {
+            // Park until the next dispatch; re-check after publishing the flag so a wake-up is never lost
+            parked.store(true, std::memory_order_seq_cst);
+            
+            if (pool.generation.load(std::memory_order_seq_cst) == seenGeneration && !threadShouldExit())
+                wakeEvent.wait(parkTimeoutMs);
+            
+            parked.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        
+        seenGeneration = pool.generation.load(std::memory_order_acquire);
+        
+        // Tasks are audio work, held to the same rules as the dispatching callback
+        const RealtimeSafety::ScopedAudioThread audioThreadScope;
+        pool.claimAndRunTasks(true);
+    }
+}
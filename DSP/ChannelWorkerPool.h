@@ -0,0 +1,80 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "RealtimeSafety.h"
+
+// Small fixed pool of real-time worker threads that run independent tasks
+// (channel lanes) from the audio callback. Nothing is allocated or locked on
+// the dispatching side: work is published through atomics, idle workers spin
+// briefly and then park, and the calling thread claims tasks itself so the
+// join never waits on a worker that was not scheduled. Workers are not pinned
+// to cores: with several instances, fixed cores would all collide while others
+// sit idle. They run at real-time priority and join the host's audio workgroup
+// where there is one, so the scheduler treats them like the callback itself.
+class ChannelWorkerPool
+{
+public:
+    ChannelWorkerPool() = default;
+    ~ChannelWorkerPool();
+    
+    // Message thread: starts numWorkers threads (clamped to the available cores), or stops
+    // them all for 0. The block timing is the scheduling hint for the real-time threads.
+    void prepare(int numWorkers, double sampleRate, int maximumBlockSize, const juce::AudioWorkgroup& workgroup);
+    void release();
+    
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+    
+    // Audio thread: runs task(0) ... task(numTasks - 1) and returns once all have finished.
+    // Falls back to running them serially while workers are not keeping up.
+    template <typename Task>
+    void run(int numTasks, Task& task)
+    {
+        runTasks(numTasks, [](void* context, int taskIndex) { (*static_cast<Task*>(context))(taskIndex); }, &task);
+    }
+    
+    bool isRunningSerially() const { return serialBlocksRemaining > 0; }
+
+private:
+    using TaskFunction = void (*)(void*, int);
+    
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(ChannelWorkerPool& owner, int index, const juce::AudioWorkgroup& workgroupToJoin);
+        void run() override;
+        
+        std::atomic<bool> parked { false };
+        juce::WaitableEvent wakeEvent;
+    
+    private:
+        ChannelWorkerPool& pool;
+        juce::AudioWorkgroup workgroup;
+    };
+    
+    void runTasks(int numTasks, TaskFunction function, void* context) noexcept;
+    void claimAndRunTasks(bool onWorker) noexcept;
+    
+    static void spinPause() noexcept;
+    
+    std::vector<std::unique_ptr<Worker>> workers;
+    
+    // Current job, published by bumping generation
+    std::atomic<uint32> generation { 0 };
+    std::atomic<int> nextTask { 0 };
+    std::atomic<int> tasksFinished { 0 };
+    std::atomic<int> taskCount { 0 };
+    std::atomic<TaskFunction> taskFunction { nullptr };
+    std::atomic<void*> taskContext { nullptr };
+    std::atomic<int> tasksRunByWorkers { 0 };
+    
+    // Serial fallback when the host leaves no spare cores
+    int starvedDispatches = 0;
+    int serialBlocksRemaining = 0;
+    
+    static constexpr int spinIterations = 4000;
+    static constexpr int parkTimeoutMs = 50;
+    static constexpr int starvedDispatchLimit = 8;
+    static constexpr int serialBackoffBlocks = 512;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelWorkerPool)
+};
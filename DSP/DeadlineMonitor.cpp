@@ -0,0 +1,230 @@
+#include "DeadlineMonitor.h"
+
+void DeadlineMonitor::prepare(double newSampleRate) noexcept
+{
+    // Counters cover the whole lifetime of the instance; only the timing reference restarts
+    sampleRate = newSampleRate;
+    previousBlockStart = 0;
+    previousElapsed = 0;
+    previousNumSamples = 0;
+}
+
+void DeadlineMonitor::reset() noexcept
+{
+    for (auto& bucket : histogram)
+        bucket.store(0, std::memory_order_relaxed);
+    
+    numBlocks.store(0, std::memory_order_relaxed);
+    numDeadlineMisses.store(0, std::memory_order_relaxed);
+    numOutliers.store(0, std::memory_order_relaxed);
+    numLateCallbacks.store(0, std::memory_order_relaxed);
+    numDroppedEvents.store(0, std::memory_order_relaxed);
+    worstLoadPercent.store(0.0f, std::memory_order_relaxed);
+    worstLateMilliseconds.store(0.0f, std::memory_order_relaxed);
+}
+
+void DeadlineMonitor::beginBlock() noexcept
+{
+    blockStart = now();
+    
+    // Callback jitter: how late this callback arrived relative to the previous block's duration
+    if (previousBlockStart != 0 && previousNumSamples > 0 && sampleRate > 0.0)
+    {
+        const auto intervalMs = static_cast<double>(blockStart - previousBlockStart) * 1.0e-6;
+        // A block that overran delays the next callback by itself; that is already a miss, not jitter
+        const auto expectedMs = juce::jmax(1000.0 * previousNumSamples / sampleRate,
+                                           static_cast<double>(previousElapsed) * 1.0e-6);
+        
+        // Gaps of a second or more are transport stops or device restarts, not jitter
+        if (intervalMs > expectedMs * lateCallbackFactor && intervalMs < 1000.0)
+        {
+            increment(numLateCallbacks);
+            
+            const auto lateMs = static_cast<float>(intervalMs - expectedMs);
+            
+            if (lateMs > worstLateMilliseconds.load(std::memory_order_relaxed))
+                worstLateMilliseconds.store(lateMs, std::memory_order_relaxed);
+            
+            Event event;
+            event.kind = Event::lateCallback;
+            event.timeNanoseconds = blockStart;
+            event.intervalMilliseconds = static_cast<float>(intervalMs);
+            event.numSamples = previousNumSamples;
+            event.configuration = configuration;
+            pushEvent(event);
+        }
+    }
+    
+    previousBlockStart = blockStart;
+}
+
+void DeadlineMonitor::endBlock(int numSamples) noexcept
+{
+    const auto elapsed = now() - blockStart;
+    previousElapsed = elapsed;
+    previousNumSamples = numSamples;
+    
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+    
+    const auto budget = numSamples * 1.0e9 / sampleRate;
+    const auto load = static_cast<float>(100.0 * static_cast<double>(elapsed) / budget);
+    
+    const auto bucket = load < 100.0f ? juce::jmax(0, static_cast<int>(load / 10.0f))
+                                      : (load < 150.0f ? 10 : (load < 200.0f ? 11 : 12));
+    increment(histogram[static_cast<size_t>(bucket)]);
+    increment(numBlocks);
+    
+    if (load > worstLoadPercent.load(std::memory_order_relaxed))
+        worstLoadPercent.store(load, std::memory_order_relaxed);
+    
+    if (load < outlierLoadPercent)
+        return;
+    
+    Event event;
+    event.kind = load >= 100.0f ? Event::deadlineMiss : Event::outlier;
+    event.timeNanoseconds = blockStart;
+    event.loadPercent = load;
+    event.numSamples = numSamples;
+    event.configuration = configuration;
+    
+    increment(event.kind == Event::deadlineMiss ? numDeadlineMisses : numOutliers);
+    pushEvent(event);
+}
+
+void DeadlineMonitor::pushEvent(const Event& event) noexcept
+{
+    const auto scope = eventFifo.write(1);
+    
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        // The log has fallen behind; keep counting rather than block
+        increment(numDroppedEvents);
+        return;
+    }
+    
+    events[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = event;
+}
+
+int DeadlineMonitor::popEvents(Event* destination, int maxEvents) noexcept
+{
+    const auto scope = eventFifo.read(maxEvents);
+    
+    for (int i = 0; i < scope.blockSize1; ++i)
+        destination[i] = events[static_cast<size_t>(scope.startIndex1 + i)];
+    
+    for (int i = 0; i < scope.blockSize2; ++i)
+        destination[scope.blockSize1 + i] = events[static_cast<size_t>(scope.startIndex2 + i)];
+    
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+DeadlineMonitor::Summary DeadlineMonitor::getSummary() const noexcept
+{
+    Summary summary;
+    
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+        summary.histogram[bucket] = histogram[bucket].load(std::memory_order_relaxed);
+    
+    summary.numBlocks = numBlocks.load(std::memory_order_relaxed);
+    summary.numDeadlineMisses = numDeadlineMisses.load(std::memory_order_relaxed);
+    summary.numOutliers = numOutliers.load(std::memory_order_relaxed);
+    summary.numLateCallbacks = numLateCallbacks.load(std::memory_order_relaxed);
+    summary.numDroppedEvents = numDroppedEvents.load(std::memory_order_relaxed);
+    summary.worstLoadPercent = worstLoadPercent.load(std::memory_order_relaxed);
+    summary.worstLateMilliseconds = worstLateMilliseconds.load(std::memory_order_relaxed);
+    return summary;
+}
+
+juce::String DeadlineMonitor::getBucketLabel(int bucket)
+{
+    if (bucket < 10)
+        return juce::String(bucket * 10) + "-" + juce::String(bucket * 10 + 10) + "%";
+    
+    return bucket == 10 ? "100-150%" : (bucket == 11 ? "150-200%" : ">200%");
+}
+
+DeadlineLog::DeadlineLog(DeadlineMonitor& monitorToUse, std::function<juce::String(juce::uint64)> describeConfigurationToUse,
+                         const juce::File& logFileToUse)
+    : monitor(monitorToUse), describeConfiguration(std::move(describeConfigurationToUse)), logFile(logFileToUse),
+      instanceTag(juce::String::toHexString(juce::Random::getSystemRandom().nextInt()).paddedLeft('0', 8))
+{
+    startTimer(flushIntervalMs);
+}
+
+DeadlineLog::~DeadlineLog()
+{
+    stopTimer();
+    flush();
+}
+
+juce::File DeadlineLog::getDefaultLogFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile(JucePlugin_Manufacturer)
+               .getChildFile(JucePlugin_Name)
+               .getChildFile("RealtimeDiagnostics.log");
+}
+
+void DeadlineLog::flush()
+{
+    juce::String lines;
+    
+    // Consecutive events nearly always share a configuration, so it is described once per run
+    juce::uint64 describedConfiguration = 0;
+    juce::String configuration;
+    bool described = false;
+    
+    // steady_clock stamps become wall-clock times relative to now
+    const auto nowNanoseconds = DeadlineMonitor::now();
+    const auto nowMs = juce::Time::currentTimeMillis();
+    
+    for (;;)
+    {
+        const auto numEvents = monitor.popEvents(pending.data(), static_cast<int>(pending.size()));
+        
+        if (numEvents == 0)
+            break;
+        
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const auto& event = pending[static_cast<size_t>(i)];
+            const auto time = juce::Time(nowMs - (nowNanoseconds - event.timeNanoseconds) / 1000000);
+            
+            if (!described || event.configuration != describedConfiguration)
+            {
+                configuration = describeConfiguration != nullptr ? describeConfiguration(event.configuration) : juce::String();
+                describedConfiguration = event.configuration;
+                described = true;
+            }
+            
+            lines << time.formatted("%Y-%m-%d %H:%M:%S") << "." << juce::String(time.getMilliseconds()).paddedLeft('0', 3)
+                  << "  " << instanceTag << "  ";
+            
+            switch (event.kind)
+            {
+                case DeadlineMonitor::Event::deadlineMiss:
+                    lines << "deadline miss   load " << juce::String(event.loadPercent, 1) << "%";
+                    break;
+                case DeadlineMonitor::Event::outlier:
+                    lines << "outlier         load " << juce::String(event.loadPercent, 1) << "%";
+                    break;
+                case DeadlineMonitor::Event::lateCallback:
+                    lines << "late callback   interval " << juce::String(event.intervalMilliseconds, 2) << " ms";
+                    break;
+            }
+            
+            lines << "  block " << event.numSamples << "  | " << configuration << juce::newLine;
+        }
+    }
+    
+    if (lines.isEmpty())
+        return;
+    
+    // Keep one previous log around instead of growing without bound
+    if (logFile.getSize() > maxLogFileBytes)
+        logFile.moveFileTo(logFile.withFileExtension("old.log"));
+    
+    logFile.getParentDirectory().createDirectory();
+    logFile.appendText(lines);
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <chrono>
+
+// Watches every audio callback against its real-time budget (numSamples / sampleRate).
+// The audio thread only touches atomics and a lock-free event FIFO; any thread can
+// read the summary, and one consumer (DeadlineLog) drains the events.
+class DeadlineMonitor
+{
+public:
+    // Load histogram: ten 10% buckets up to the deadline, then 100-150%, 150-200% and beyond
+    static constexpr int numBuckets = 13;
+    
+    // Blocks above this load count as long-tail outliers even when they make the deadline
+    static constexpr float outlierLoadPercent = 70.0f;
+    
+    // A callback arriving this many block durations after the previous one was late
+    static constexpr double lateCallbackFactor = 2.0;
+    
+    struct Event
+    {
+        enum Kind { deadlineMiss, outlier, lateCallback };
+        
+        Kind kind = deadlineMiss;
+        juce::int64 timeNanoseconds = 0; // steady_clock
+        float loadPercent = 0.0f;
+        float intervalMilliseconds = 0.0f;
+        int numSamples = 0;
+        juce::uint64 configuration = 0; // as set when the event happened
+    };
+    
+    struct Summary
+    {
+        std::array<juce::uint32, numBuckets> histogram {};
+        juce::uint64 numBlocks = 0;
+        juce::uint64 numDeadlineMisses = 0;
+        juce::uint64 numOutliers = 0;
+        juce::uint64 numLateCallbacks = 0;
+        juce::uint64 numDroppedEvents = 0;
+        float worstLoadPercent = 0.0f;
+        float worstLateMilliseconds = 0.0f;
+    };
+    
+    DeadlineMonitor() = default;
+    
+    void prepare(double newSampleRate) noexcept;
+    void reset() noexcept;
+    
+    // Audio thread (or while no callback runs): a compact code for the active settings,
+    // copied into every event so the log can describe them as they were at the time
+    void setConfiguration(juce::uint64 newConfiguration) noexcept { configuration = newConfiguration; }
+    
+    // Audio thread: brackets one callback. Offline renders are not monitored.
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(DeadlineMonitor& monitorToUse, int numSamplesToUse, bool nonRealtime) noexcept
+            : monitor(nonRealtime ? nullptr : &monitorToUse), numSamples(numSamplesToUse)
+        {
+            if (monitor != nullptr)
+                monitor->beginBlock();
+        }
+        
+        ~ScopedBlock()
+        {
+            if (monitor != nullptr)
+                monitor->endBlock(numSamples);
+        }
+    
+    private:
+        DeadlineMonitor* monitor;
+        int numSamples;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+    
+    // Any thread
+    Summary getSummary() const noexcept;
+    static juce::String getBucketLabel(int bucket);
+    
+    // Single consumer: copies up to maxEvents of the oldest events out, returns how many
+    int popEvents(Event* destination, int maxEvents) noexcept;
+    
+    static juce::int64 now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    void beginBlock() noexcept;
+    void endBlock(int numSamples) noexcept;
+    void pushEvent(const Event& event) noexcept;
+    
+    template <typename Type>
+    static void increment(std::atomic<Type>& counter) noexcept
+    {
+        // Single writer, so a plain load/store is enough and avoids a locked RMW
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    double sampleRate = 0.0;
+    juce::int64 blockStart = 0;
+    juce::int64 previousBlockStart = 0;
+    juce::int64 previousElapsed = 0;
+    int previousNumSamples = 0;
+    juce::uint64 configuration = 0;
+    
+    std::array<std::atomic<juce::uint32>, numBuckets> histogram {};
+    std::atomic<juce::uint64> numBlocks { 0 };
+    std::atomic<juce::uint64> numDeadlineMisses { 0 };
+    std::atomic<juce::uint64> numOutliers { 0 };
+    std::atomic<juce::uint64> numLateCallbacks { 0 };
+    std::atomic<juce::uint64> numDroppedEvents { 0 };
+    std::atomic<float> worstLoadPercent { 0.0f };
+    std::atomic<float> worstLateMilliseconds { 0.0f };
+    
+    static constexpr int eventCapacity = 256;
+    juce::AbstractFifo eventFifo { eventCapacity };
+    std::array<Event, eventCapacity> events;
+    
+    JUCE_DECLARE_NON_COPYABLE(DeadlineMonitor)
+};
+
+// Message thread: periodically appends the monitor's events to a text log, each line
+// tagged with the instance and with the configuration that was active when the event
+// happened, so field reports of crackles can be matched to settings. Every instance
+// appends to the same file; the tag tells them apart.
+class DeadlineLog : private juce::Timer
+{
+public:
+    // describeConfiguration turns an event's configuration code into text
+    DeadlineLog(DeadlineMonitor& monitorToUse, std::function<juce::String(juce::uint64)> describeConfigurationToUse,
+                const juce::File& logFileToUse = getDefaultLogFile());
+    ~DeadlineLog() override;
+    
+    const juce::File& getLogFile() const { return logFile; }
+    const juce::String& getInstanceTag() const { return instanceTag; }
+    static juce::File getDefaultLogFile();
+    
+    // Writes any pending events now
+    void flush();
+
+private:
+    void timerCallback() override { flush(); }
+    
+    DeadlineMonitor& monitor;
+    std::function<juce::String(juce::uint64)> describeConfiguration;
+    juce::File logFile;
+    juce::String instanceTag;
+    std::array<DeadlineMonitor::Event, 64> pending;
+    
+    static constexpr int flushIntervalMs = 2000;
+    static constexpr juce::int64 maxLogFileBytes = 1024 * 1024;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeadlineLog)
+};
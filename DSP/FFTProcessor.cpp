@@ -1,8 +1,14 @@
 #include "FFTProcessor.h"
+#include "TraceRecorder.h"
+#include "MemoryFootprint.h"
 
 FFTProcessor::FFTProcessor() 
-    : fft(fftOrder), window(fftSize, juce::dsp::WindowingFunction<float>::hann)
 {
+    window = SharedResourceCache::get<juce::dsp::WindowingFunction<float>>("Hann window " + juce::String(static_cast<int>(fftSize)), []
+    {
+        return std::make_shared<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::hann);
+    });
+    
     fftBuffer.resize(fftSize * 2, 0.0f); // Complex pairs
     windowBuffer.resize(fftSize, 0.0f);
     magnitudeSpectrum.resize(fftSize / 2, 0.0f);
@@ -30,9 +36,12 @@ void FFTProcessor::reset()
     
     bufferIndex = 0;
     bufferFull = false;
+    samplesSinceLastFFT = 0;
+    newSpectrum = false;
 }
 
-std::vector<float> FFTProcessor::getSpectrum(const juce::dsp::AudioBlock<const float>& block)
+template <typename SampleType>
+const std::vector<float>& FFTProcessor::getSpectrum(const juce::dsp::AudioBlock<const SampleType>& block)
 {
     const auto numSamples = block.getNumSamples();
     const auto numChannels = block.getNumChannels();
@@ -45,7 +54,7 @@ std::vector<float> FFTProcessor::getSpectrum(const juce::dsp::AudioBlock<const f
         // Mix all channels
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
-            mixedSample += block.getSample(static_cast<int>(channel), static_cast<int>(sample));
+            mixedSample += static_cast<float>(block.getSample(static_cast<int>(channel), static_cast<int>(sample)));
         }
         mixedSample /= static_cast<float>(numChannels);
         
@@ -57,9 +66,15 @@ std::vector<float> FFTProcessor::getSpectrum(const juce::dsp::AudioBlock<const f
             bufferFull = true;
     }
     
-    // Process FFT if we have enough data
-    if (bufferFull)
+    samplesSinceLastFFT += numSamples;
+    newSpectrum = false;
+    
+    // Process FFT once enough new data has arrived, independent of how the block was split
+    if (bufferFull && samplesSinceLastFFT >= hopSize)
     {
+        samplesSinceLastFFT = 0;
+        newSpectrum = true;
+
         processFFT();
         calculateMagnitudeSpectrum();
     }
@@ -67,6 +82,9 @@ std::vector<float> FFTProcessor::getSpectrum(const juce::dsp::AudioBlock<const f
     return magnitudeSpectrum;
 }
 
+template const std::vector<float>& FFTProcessor::getSpectrum<float>(const juce::dsp::AudioBlock<const float>&);
+template const std::vector<float>& FFTProcessor::getSpectrum<double>(const juce::dsp::AudioBlock<const double>&);
+
 std::vector<float> FFTProcessor::getFrequencies() const
 {
     return frequencies;
@@ -85,8 +103,16 @@ float FFTProcessor::getMagnitudeAtFrequency(float frequency, const std::vector<f
     return spectrum[binIndex];
 }
 
+size_t FFTProcessor::getMemoryUsage() const
+{
+    return MemoryFootprint::bytesOf(fftBuffer) + MemoryFootprint::bytesOf(windowBuffer)
+         + MemoryFootprint::bytesOf(magnitudeSpectrum) + MemoryFootprint::bytesOf(frequencies);
+}
+
 void FFTProcessor::processFFT()
 {
+    const Trace::ScopedEvent trace("FFT");
+    
     // Copy windowed data to FFT buffer (complex format)
     for (size_t i = 0; i < fftSize; ++i)
     {
@@ -96,7 +122,7 @@ void FFTProcessor::processFFT()
     }
     
     // Apply window function
-    window.multiplyWithWindowingTable(fftBuffer.data(), fftSize);
+    window->multiplyWithWindowingTable(fftBuffer.data(), fftSize);
     
     // Perform FFT
     fft.performFrequencyOnlyForwardTransform(fftBuffer.data());
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SharedResourceCache.h"
 
 class FFTProcessor
 {
@@ -11,13 +12,25 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
     
-    std::vector<float> getSpectrum(const juce::dsp::AudioBlock<const float>& block);
+    // Analysis always runs in single precision, whatever the block's sample type.
+    // The returned spectrum is owned by the processor and valid until the next call.
+    template <typename SampleType>
+    const std::vector<float>& getSpectrum(const juce::dsp::AudioBlock<const SampleType>& block);
     std::vector<float> getFrequencies() const;
     float getMagnitudeAtFrequency(float frequency, const std::vector<float>& spectrum) const;
+    
+    // True if the last getSpectrum() call produced a new FFT frame
+    bool hasNewSpectrum() const { return newSpectrum; }
+    
+    // Heap memory owned by this processor, in bytes; the FFT engine and shared window are not counted
+    size_t getMemoryUsage() const;
 
 private:
-    juce::dsp::FFT fft;
-    juce::dsp::WindowingFunction<float> window;
+    // The engine stays per instance: JUCE's fallback FFT serialises perform() on an
+    // internal lock, so a shared one would make every instance wait for the others.
+    // The window table is only ever read, so all instances share one.
+    juce::dsp::FFT fft { static_cast<int>(fftOrder) };
+    std::shared_ptr<const juce::dsp::WindowingFunction<float>> window;
     
     std::vector<float> fftBuffer;
     std::vector<float> windowBuffer;
@@ -31,6 +44,11 @@ private:
     size_t bufferIndex = 0;
     bool bufferFull = false;
     
+    // New frames are only computed every hopSize input samples
+    static constexpr size_t hopSize = 1024;
+    size_t samplesSinceLastFFT = 0;
+    bool newSpectrum = false;
+    
     void processFFT();
     void calculateMagnitudeSpectrum();
 };
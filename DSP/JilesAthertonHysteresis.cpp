@@ -0,0 +1,155 @@
+#include "JilesAthertonHysteresis.h"
+#include "MemoryFootprint.h"
+
+template <typename SampleType>
+JilesAthertonHysteresis<SampleType>::JilesAthertonHysteresis()
+{
+    updateCoefficients();
+}
+
+template <typename SampleType>
+void JilesAthertonHysteresis<SampleType>::prepare(double sampleRate, int numChannels)
+{
+    currentSampleRate = sampleRate;
+    states.resize(static_cast<size_t>(juce::jmax(0, numChannels)));
+    
+    updateCoefficients();
+    reset();
+}
+
+template <typename SampleType>
+void JilesAthertonHysteresis<SampleType>::reset()
+{
+    std::fill(states.begin(), states.end(), State());
+}
+
+template <typename SampleType>
+void JilesAthertonHysteresis<SampleType>::updateCoefficients()
+{
+    auto& coeffs = coefficients;
+    
+    coeffs.oneOverA = SampleType(1) / coeffs.a;
+    coeffs.oneMinusC = SampleType(1) - coeffs.c;
+    coeffs.kOneMinusC = coeffs.k * coeffs.oneMinusC;
+    coeffs.cOverA = coeffs.c * coeffs.oneOverA;
+    coeffs.cAlphaOverA = coeffs.c * coeffs.alpha * coeffs.oneOverA;
+    
+    coeffs.sampleTime = static_cast<SampleType>(1.0 / currentSampleRate);
+    coeffs.derivativeGain = static_cast<SampleType>((1.0 + static_cast<double>(derivativeAlpha)) * currentSampleRate);
+}
+
+template <typename SampleType>
+void JilesAthertonHysteresis<SampleType>::process(juce::dsp::AudioBlock<SampleType>& block, SampleType startGain, SampleType gainStep,
+                                                  size_t firstChannel) noexcept
+{
+    if (firstChannel >= states.size())
+        return;
+    
+    const auto numChannels = juce::jmin(block.getNumChannels(), states.size() - firstChannel);
+    
+    // Step channels in pairs; an odd last channel runs with the second lane idle
+    for (size_t first = 0; first < numChannels; first += laneWidth)
+    {
+        const auto numLanesUsed = juce::jmin(laneWidth, numChannels - first);
+        
+        std::array<SampleType*, laneWidth> channels {};
+        std::array<State*, laneWidth> laneStates {};
+        
+        for (size_t lane = 0; lane < laneWidth; ++lane)
+        {
+            const auto channel = first + juce::jmin(lane, numLanesUsed - 1);
+            channels[lane] = block.getChannelPointer(channel);
+            laneStates[lane] = &states[firstChannel + channel];
+        }
+        
+        processLanes(channels, laneStates, numLanesUsed, block.getNumSamples(), startGain, gainStep);
+    }
+}
+
+template <typename SampleType>
+void JilesAthertonHysteresis<SampleType>::processLanes(std::array<SampleType*, laneWidth> channels, std::array<State*, laneWidth> laneStates,
+                                                       size_t numLanesUsed, size_t numSamples, SampleType startGain, SampleType gainStep) noexcept
+{
+    const auto coeffs = coefficients;
+    const auto sampleTime = coeffs.sampleTime;
+    
+    Lanes m {}, h {}, hd {};
+    for (size_t lane = 0; lane < laneWidth; ++lane)
+    {
+        m[lane] = laneStates[lane]->magnetisation;
+        h[lane] = laneStates[lane]->field;
+        hd[lane] = laneStates[lane]->fieldDerivative;
+    }
+    
+    Lanes input {}, hNew {}, hdNew {}, hMid {}, hdMid {}, trial {};
+    Lanes k1 {}, k2 {}, k3 {}, k4 {};
+    SampleType driveGain = startGain;
+    
+    for (size_t sample = 0; sample < numSamples; ++sample)
+    {
+        driveGain += gainStep;
+        
+        for (size_t lane = 0; lane < laneWidth; ++lane)
+        {
+            input[lane] = channels[lane][sample];
+            hNew[lane] = input[lane] * driveGain;
+            hdNew[lane] = coeffs.derivativeGain * (hNew[lane] - h[lane]) - derivativeAlpha * hd[lane];
+            hMid[lane] = SampleType(0.5) * (hNew[lane] + h[lane]);
+            hdMid[lane] = SampleType(0.5) * (hdNew[lane] + hd[lane]);
+        }
+        
+        slope(coeffs, m, h, hd, k1);
+        
+        for (size_t lane = 0; lane < laneWidth; ++lane)
+            trial[lane] = m[lane] + SampleType(0.5) * sampleTime * k1[lane];
+        
+        slope(coeffs, trial, hMid, hdMid, k2);
+        
+        if (solver == RK4)
+        {
+            for (size_t lane = 0; lane < laneWidth; ++lane)
+                trial[lane] = m[lane] + SampleType(0.5) * sampleTime * k2[lane];
+            
+            slope(coeffs, trial, hMid, hdMid, k3);
+            
+            for (size_t lane = 0; lane < laneWidth; ++lane)
+                trial[lane] = m[lane] + sampleTime * k3[lane];
+            
+            slope(coeffs, trial, hNew, hdNew, k4);
+            
+            for (size_t lane = 0; lane < laneWidth; ++lane)
+                m[lane] += sampleTime * (k1[lane] + SampleType(2) * (k2[lane] + k3[lane]) + k4[lane]) / SampleType(6);
+        }
+        else
+        {
+            for (size_t lane = 0; lane < laneWidth; ++lane)
+                m[lane] += sampleTime * k2[lane];
+        }
+        
+        // Guard against the solver running away on extreme input
+        for (size_t lane = 0; lane < laneWidth; ++lane)
+            m[lane] = std::isfinite(m[lane]) ? juce::jlimit(SampleType(-1), SampleType(1), m[lane]) : SampleType(0);
+        
+        h = hNew;
+        hd = hdNew;
+        
+        for (size_t lane = 0; lane < numLanesUsed; ++lane)
+            channels[lane][sample] = m[lane];
+    }
+    
+    for (size_t lane = 0; lane < numLanesUsed; ++lane)
+    {
+        laneStates[lane]->magnetisation = m[lane];
+        laneStates[lane]->field = h[lane];
+        laneStates[lane]->fieldDerivative = hd[lane];
+    }
+}
+
+template <typename SampleType>
+size_t JilesAthertonHysteresis<SampleType>::getMemoryUsage() const
+{
+    return MemoryFootprint::bytesOf(states);
+}
+
+template class JilesAthertonHysteresis<float>;
+template class JilesAthertonHysteresis<double>;
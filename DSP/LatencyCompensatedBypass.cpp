@@ -0,0 +1,163 @@
+#include "LatencyCompensatedBypass.h"
+#include "MemoryFootprint.h"
+
+template <typename SampleType>
+LatencyCompensatedBypass<SampleType>::LatencyCompensatedBypass()
+{
+}
+
+template <typename SampleType>
+void LatencyCompensatedBypass<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    const auto numChannels = static_cast<int>(spec.numChannels);
+    const auto maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+    
+    // Room for the longest delay plus the current block
+    history.setSize(numChannels, maxLatencySamples + maxBlockSize);
+    dryBuffer.setSize(numChannels, maxBlockSize);
+    
+    fade.reset(spec.sampleRate, fadeSeconds);
+    
+    reset();
+}
+
+template <typename SampleType>
+void LatencyCompensatedBypass<SampleType>::reset()
+{
+    history.clear();
+    writePosition = 0;
+    lastBlockSize = 0;
+    
+    // Keep the bypass state, but drop any fade or warm-up in progress
+    if (warmingUp)
+        fade.setTargetValue(SampleType(0));
+    
+    fade.setCurrentAndTargetValue(fade.getTargetValue());
+    warmingUp = false;
+}
+
+template <typename SampleType>
+void LatencyCompensatedBypass<SampleType>::setLatency(int samples)
+{
+    latency = juce::jlimit(0, maxLatencySamples, samples);
+}
+
+template <typename SampleType>
+bool LatencyCompensatedBypass<SampleType>::setBypassed(bool shouldBeBypassed)
+{
+    if (shouldBeBypassed)
+    {
+        // The dry signal is still fully in the output during a warm-up, so abandoning it needs no fade
+        warmingUp = false;
+        fade.setTargetValue(SampleType(1));
+        return false;
+    }
+    
+    if (warmingUp || fade.getTargetValue() < SampleType(0.5))
+        return false;
+    
+    // Caught mid-fade the chain's state is current, so fade straight back
+    if (fade.isSmoothing())
+    {
+        fade.setTargetValue(SampleType(0));
+        return false;
+    }
+    
+    // The fade starts from mixDry() once the warm-up is over
+    warmingUp = true;
+    warmUpElapsed = 0;
+    return true;
+}
+
+template <typename SampleType>
+void LatencyCompensatedBypass<SampleType>::pushInput(const juce::dsp::AudioBlock<const SampleType>& block)
+{
+    const auto capacity = history.getNumSamples();
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    const auto numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), history.getNumChannels());
+    
+    jassert(numSamples <= capacity - maxLatencySamples);
+    
+    if (capacity == 0)
+        return;
+    
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* source = block.getChannelPointer(static_cast<size_t>(channel));
+        const auto firstPart = juce::jmin(numSamples, capacity - writePosition);
+        
+        history.copyFrom(channel, writePosition, source, firstPart);
+        
+        if (firstPart < numSamples)
+            history.copyFrom(channel, 0, source + firstPart, numSamples - firstPart);
+    }
+    
+    writePosition = (writePosition + numSamples) % capacity;
+    lastBlockSize = numSamples;
+}
+
+template <typename SampleType>
+void LatencyCompensatedBypass<SampleType>::readHistory(juce::dsp::AudioBlock<SampleType>& destination, int samplesBefore) const
+{
+    const auto capacity = history.getNumSamples();
+    const auto numSamples = static_cast<int>(destination.getNumSamples());
+    const auto numChannels = juce::jmin(static_cast<int>(destination.getNumChannels()), history.getNumChannels());
+    
+    if (capacity == 0)
+        return;
+    
+    const auto readPosition = ((writePosition - lastBlockSize - samplesBefore) % capacity + capacity) % capacity;
+    
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* target = destination.getChannelPointer(static_cast<size_t>(channel));
+        const auto* source = history.getReadPointer(channel);
+        const auto firstPart = juce::jmin(numSamples, capacity - readPosition);
+        
+        std::copy(source + readPosition, source + readPosition + firstPart, target);
+        std::copy(source, source + (numSamples - firstPart), target + firstPart);
+    }
+}
+
+template <typename SampleType>
+void LatencyCompensatedBypass<SampleType>::processBypassed(juce::dsp::AudioBlock<SampleType>& block)
+{
+    readHistory(block, latency);
+}
+
+template <typename SampleType>
+void LatencyCompensatedBypass<SampleType>::mixDry(juce::dsp::AudioBlock<SampleType>& block)
+{
+    const auto numSamples = juce::jmin(block.getNumSamples(), static_cast<size_t>(dryBuffer.getNumSamples()));
+    const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(dryBuffer.getNumChannels()));
+    
+    auto dry = juce::dsp::AudioBlock<SampleType>(dryBuffer).getSubBlock(0, numSamples);
+    readHistory(dry, latency);
+    
+    for (size_t sample = 0; sample < numSamples; ++sample)
+    {
+        // Latency changes during the warm-up extend or shorten it
+        if (warmingUp && ++warmUpElapsed >= getWarmUpLength())
+        {
+            warmingUp = false;
+            fade.setTargetValue(SampleType(0));
+        }
+        
+        const auto dryAmount = fade.getNextValue();
+        
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* output = block.getChannelPointer(channel);
+            output[sample] += dryAmount * (dry.getChannelPointer(channel)[sample] - output[sample]);
+        }
+    }
+}
+
+template <typename SampleType>
+size_t LatencyCompensatedBypass<SampleType>::getMemoryUsage() const
+{
+    return MemoryFootprint::bytesOf(history) + MemoryFootprint::bytesOf(dryBuffer);
+}
+
+template class LatencyCompensatedBypass<float>;
+template class LatencyCompensatedBypass<double>;
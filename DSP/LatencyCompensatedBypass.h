@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Host bypass for the processing chain. The dry signal is delayed by the chain's
+// latency so the output does not jump, and entering or leaving bypass crossfades
+// over a few milliseconds. While fully bypassed only the input history is written.
+// Leaving bypass first runs the chain on live input with the dry signal still in the
+// output, and crossfades only once its filters and oversampler hold current audio
+// instead of what preceded the bypass; the warm-up costs no more than a normal block.
+template <typename SampleType>
+class LatencyCompensatedBypass
+{
+public:
+    static constexpr int maxLatencySamples = 2048;
+    
+    LatencyCompensatedBypass();
+    ~LatencyCompensatedBypass() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    
+    // Delay applied to the dry signal
+    void setLatency(int samples);
+    int getLatency() const { return latency; }
+    
+    // Starts a crossfade when the state changes. Returns true when leaving a full
+    // bypass, i.e. the chain resumes from stale state and starts its warm-up.
+    bool setBypassed(bool shouldBeBypassed);
+    
+    bool isFullyBypassed() const { return !warmingUp && !fade.isSmoothing() && fade.getTargetValue() > SampleType(0.5); }
+    bool isFading() const { return warmingUp || fade.isSmoothing(); }
+    
+    // Records a host block; call once per block before anything modifies it
+    void pushInput(const juce::dsp::AudioBlock<const SampleType>& block);
+    
+    // Replaces the block with the delayed dry input
+    void processBypassed(juce::dsp::AudioBlock<SampleType>& block);
+    
+    // Blends the delayed dry input into the processed block along the crossfade;
+    // during the warm-up the block is replaced with it
+    void mixDry(juce::dsp::AudioBlock<SampleType>& block);
+    
+    // Heap memory allocated by prepare(), in bytes (see MemoryFootprint)
+    size_t getMemoryUsage() const;
+
+private:
+    // Copies history starting samplesBefore samples ahead of the last pushed block
+    void readHistory(juce::dsp::AudioBlock<SampleType>& destination, int samplesBefore) const;
+    
+    // Two latencies refill a linear-phase FIR completely; the rest settles the oversampler and short IIR memories
+    int getWarmUpLength() const { return 2 * latency + minWarmUpSamples; }
+    
+    static constexpr double fadeSeconds = 0.005;
+    static constexpr int minWarmUpSamples = 256;
+    
+    juce::AudioBuffer<SampleType> history;
+    juce::AudioBuffer<SampleType> dryBuffer;
+    int writePosition = 0;
+    int lastBlockSize = 0;
+    int latency = 0;
+    
+    // Samples the chain has processed since leaving a full bypass, while the dry signal is still heard
+    bool warmingUp = false;
+    int warmUpElapsed = 0;
+    
+    // 0 = processed, 1 = bypassed
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> fade;
+};
@@ -0,0 +1,168 @@
+#include "LevelMeter.h"
+#include "MemoryFootprint.h"
+
+template <typename SampleType>
+LevelMeter<SampleType>::LevelMeter()
+{
+}
+
+template <typename SampleType>
+void LevelMeter<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    channels.clear();
+    channels.resize(spec.numChannels);
+
+    // K-weighting filters run per channel, so prepare them as mono
+    juce::dsp::ProcessSpec monoSpec { spec.sampleRate, spec.maximumBlockSize, 1 };
+
+    for (auto& channel : channels)
+        channel.kWeighting.prepare(monoSpec);
+
+    reset();
+}
+
+template <typename SampleType>
+void LevelMeter<SampleType>::reset()
+{
+    for (auto& channel : channels)
+    {
+        channel.kWeighting.reset();
+        channel.rms = 0.0f;
+        channel.peak = 0.0f;
+        channel.truePeak = 0.0f;
+        channel.history.fill(SampleType(0));
+    }
+
+    blockRMS = 0.0f;
+    blockPeak = 0.0f;
+    kWeightedRMS = 0.0f;
+}
+
+template <typename SampleType>
+void LevelMeter<SampleType>::process(const juce::dsp::AudioBlock<const SampleType>& block)
+{
+    const auto numSamples = block.getNumSamples();
+    const auto numChannels = juce::jmin(block.getNumChannels(), channels.size());
+
+    if (numSamples == 0 || numChannels == 0)
+        return;
+
+    SampleType totalSum = 0;
+    SampleType totalWeightedSum = 0;
+    SampleType totalPeak = 0;
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto& state = channels[channel];
+        const auto* channelData = block.getChannelPointer(channel);
+
+        SampleType sum = 0;
+        SampleType weightedSum = 0;
+        SampleType peak = 0;
+        SampleType interSamplePeak = 0;
+
+        auto h0 = state.history[0];
+        auto h1 = state.history[1];
+        auto h2 = state.history[2];
+
+        // One sweep gathers raw energy, peak and K-weighted energy together
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            const SampleType value = channelData[sample];
+            const SampleType weighted = state.kWeighting.process(value);
+
+            sum += value * value;
+            weightedSum += weighted * weighted;
+            peak = juce::jmax(peak, std::abs(value));
+
+            // Cubic midpoint between the previous two samples (2x true-peak estimate)
+            const SampleType midpoint = (SampleType(9) * (h1 + h2) - (h0 + value)) * SampleType(0.0625);
+            interSamplePeak = juce::jmax(interSamplePeak, std::abs(midpoint));
+
+            h0 = h1;
+            h1 = h2;
+            h2 = value;
+        }
+
+        state.history = { h0, h1, h2 };
+        state.rms = static_cast<float>(std::sqrt(sum / static_cast<SampleType>(numSamples)));
+        state.peak = static_cast<float>(peak);
+        state.truePeak = static_cast<float>(juce::jmax(peak, interSamplePeak));
+
+        totalSum += sum;
+        totalWeightedSum += weightedSum;
+        totalPeak = juce::jmax(totalPeak, peak);
+    }
+
+    const auto totalSamples = static_cast<SampleType>(numSamples * numChannels);
+    blockRMS = static_cast<float>(std::sqrt(totalSum / totalSamples));
+    blockPeak = static_cast<float>(totalPeak);
+    kWeightedRMS = static_cast<float>(std::sqrt(totalWeightedSum / totalSamples));
+}
+
+template <typename SampleType>
+float LevelMeter<SampleType>::getRMS(int channel) const
+{
+    if (channel >= 0 && static_cast<size_t>(channel) < channels.size())
+        return channels[static_cast<size_t>(channel)].rms;
+    return 0.0f;
+}
+
+template <typename SampleType>
+float LevelMeter<SampleType>::getPeak(int channel) const
+{
+    if (channel >= 0 && static_cast<size_t>(channel) < channels.size())
+        return channels[static_cast<size_t>(channel)].peak;
+    return 0.0f;
+}
+
+template <typename SampleType>
+float LevelMeter<SampleType>::getTruePeak(int channel) const
+{
+    if (channel >= 0 && static_cast<size_t>(channel) < channels.size())
+        return channels[static_cast<size_t>(channel)].truePeak;
+    return 0.0f;
+}
+
+// K-weighting filter implementation
+template <typename SampleType>
+void LevelMeter<SampleType>::KWeightingFilter::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // Approximate K-weighting with high shelf + high pass
+    // High shelf at ~4kHz (+4dB)
+    auto highShelfCoeffs = juce::dsp::IIR::Coefficients<SampleType>::makeHighShelf(
+        spec.sampleRate, SampleType(4000), SampleType(0.7), juce::Decibels::decibelsToGain(SampleType(4)));
+    highShelf.coefficients = highShelfCoeffs;
+
+    // High pass at ~38Hz
+    auto highPassCoeffs = juce::dsp::IIR::Coefficients<SampleType>::makeHighPass(
+        spec.sampleRate, SampleType(38), SampleType(0.5));
+    highPass.coefficients = highPassCoeffs;
+
+    highShelf.prepare(spec);
+    highPass.prepare(spec);
+}
+
+template <typename SampleType>
+void LevelMeter<SampleType>::KWeightingFilter::reset()
+{
+    highShelf.reset();
+    highPass.reset();
+}
+
+template <typename SampleType>
+SampleType LevelMeter<SampleType>::KWeightingFilter::process(SampleType sample)
+{
+    SampleType filtered = highPass.processSample(sample);
+    filtered = highShelf.processSample(filtered);
+    return filtered;
+}
+
+template <typename SampleType>
+size_t LevelMeter<SampleType>::getMemoryUsage() const
+{
+    return MemoryFootprint::bytesOf(channels);
+}
+
+template class LevelMeter<float>;
+template class LevelMeter<double>;
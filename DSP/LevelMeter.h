@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Single-pass block meter: sum of squares, absolute peak, an inter-sample
+// (true) peak estimate and K-weighted energy for every channel are gathered
+// in one sweep over the buffer.
+template <typename SampleType>
+class LevelMeter
+{
+public:
+    LevelMeter();
+    ~LevelMeter() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void process(const juce::dsp::AudioBlock<const SampleType>& block);
+
+    // Per-channel results of the last processed block
+    float getRMS(int channel) const;
+    float getPeak(int channel) const;
+    float getTruePeak(int channel) const;
+
+    // Results summed over all channels of the last processed block
+    float getBlockRMS() const { return blockRMS; }
+    float getBlockPeak() const { return blockPeak; }
+    float getKWeightedRMS() const { return kWeightedRMS; }
+
+    size_t getNumChannels() const { return channels.size(); }
+
+    // Heap memory allocated by prepare(), in bytes (see MemoryFootprint)
+    size_t getMemoryUsage() const;
+
+private:
+    // K-weighted filters for loudness measurement (approximation)
+    struct KWeightingFilter
+    {
+        juce::dsp::IIR::Filter<SampleType> highShelf;
+        juce::dsp::IIR::Filter<SampleType> highPass;
+        void prepare(const juce::dsp::ProcessSpec& spec);
+        void reset();
+        SampleType process(SampleType sample);
+    };
+
+    struct ChannelState
+    {
+        KWeightingFilter kWeighting;
+        float rms = 0.0f;
+        float peak = 0.0f;
+        float truePeak = 0.0f;
+        
+        // Last three samples, kept across blocks for inter-sample peak estimation
+        std::array<SampleType, 3> history {};
+    };
+
+    std::vector<ChannelState> channels;
+
+    float blockRMS = 0.0f;
+    float blockPeak = 0.0f;
+    float kWeightedRMS = 0.0f;
+};
@@ -1,75 +1,217 @@
 #include "LinearPhaseFilters.h"
+#include "MemoryFootprint.h"
+#include "TraceRecorder.h"
 
-LinearPhaseFilters::LinearPhaseFilters()
+template <typename SampleType>
+LinearPhaseFilters<SampleType>::LinearPhaseFilters(int cutsToUse)
+    : cuts(cutsToUse)
 {
 }
 
-void LinearPhaseFilters::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = static_cast<float>(spec.sampleRate);
+    kernelFadeSamples = juce::jmax(1, juce::roundToInt(spec.sampleRate * kernelFadeSeconds));
     
-    for (auto& filter : lowCutFilters)
-        filter.prepare(spec);
-    
-    for (auto& filter : highCutFilters)
-        filter.prepare(spec);
-    
-    updateLowCutFilter();
-    updateHighCutFilter();
+    // Cuts the section does not provide get neither kernels nor history
+    prepareCut(lowCutState, usesCut(lowCut) ? spec.numChannels : 0, lowCutFreq, false);
+    prepareCut(highCutState, usesCut(highCut) ? spec.numChannels : 0, highCutFreq, true);
     
     reset();
 }
 
-void LinearPhaseFilters::reset()
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::prepareCut(Cut& cut, size_t numChannels, float frequency, bool highPass)
 {
-    for (auto& filter : lowCutFilters)
-        filter.reset();
+    // Allocated here and rewritten in place, so frequency changes never allocate
+    for (auto& kernel : cut.kernels)
+        kernel.assign(numChannels > 0 ? kernelLength : 0, SampleType(0));
+    
+    cut.histories.assign(numChannels, std::vector<SampleType>(2 * kernelLength, SampleType(0)));
+    cut.historyPositions.assign(numChannels, 0);
     
-    for (auto& filter : highCutFilters)
-        filter.reset();
+    cut.activeKernel = 0;
+    cut.fadePosition = -1;
+    cut.designedFrequency = frequency;
+    cut.requestedFrequency = frequency;
+    
+    if (numChannels > 0)
+    {
+        if (highPass)
+            designHighCutKernel(cut.kernels[0].data(), frequency);
+        else
+            designLowCutKernel(cut.kernels[0].data(), frequency);
+    }
 }
 
-void LinearPhaseFilters::setEnabled(bool isEnabled)
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::reset()
+{
+    for (auto* cut : { &lowCutState, &highCutState })
+    {
+        for (auto& history : cut->histories)
+            std::fill(history.begin(), history.end(), SampleType(0));
+        
+        std::fill(cut->historyPositions.begin(), cut->historyPositions.end(), size_t(0));
+        
+        // Nothing is audible yet, so a fade in progress can finish at once
+        if (cut->fadePosition >= 0)
+        {
+            cut->activeKernel = 1 - cut->activeKernel;
+            cut->fadePosition = -1;
+        }
+    }
+}
+
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::setEnabled(bool isEnabled)
 {
     enabled = isEnabled;
 }
 
-void LinearPhaseFilters::setLowCutFrequency(float frequency)
+template <typename SampleType>
+int LinearPhaseFilters<SampleType>::getNumActiveFilters() const
+{
+    if (!enabled)
+        return 0;
+    
+    return (usesCut(lowCut) ? 1 : 0) + (usesCut(highCut) ? 1 : 0);
+}
+
+template <typename SampleType>
+double LinearPhaseFilters<SampleType>::getLatencySamples() const
+{
+    // Each kernel is symmetric about its centre tap, which is where an impulse comes out
+    return getNumActiveFilters() * static_cast<double>(filterOrder / 2);
+}
+
+template <typename SampleType>
+int LinearPhaseFilters<SampleType>::getTailLengthSamples() const
+{
+    // Each active FIR holds one filter length of history
+    return getNumActiveFilters() * static_cast<int>(kernelLength);
+}
+
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::setLowCutFrequency(float frequency)
 {
     if (std::abs(lowCutFreq - frequency) > 0.1f)
     {
         lowCutFreq = juce::jlimit(20.0f, sampleRate * 0.45f, frequency);
-        updateLowCutFilter();
+        lowCutState.requestedFrequency = lowCutFreq;
     }
 }
 
-void LinearPhaseFilters::setHighCutFrequency(float frequency)
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::setHighCutFrequency(float frequency)
 {
     if (std::abs(highCutFreq - frequency) > 0.1f)
     {
         highCutFreq = juce::jlimit(1000.0f, sampleRate * 0.45f, frequency);
-        updateHighCutFilter();
+        highCutState.requestedFrequency = highCutFreq;
+    }
+}
+
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::processCut(Cut& cut, juce::dsp::AudioBlock<SampleType>& block, bool highPass)
+{
+    // A moved cutoff gets a new kernel once the previous fade is over; whatever the
+    // cutoff did in between is picked up by the next design
+    if (cut.fadePosition < 0 && cut.requestedFrequency != cut.designedFrequency)
+    {
+        auto* next = cut.kernels[1 - cut.activeKernel].data();
+        
+        if (highPass)
+            designHighCutKernel(next, cut.requestedFrequency);
+        else
+            designLowCutKernel(next, cut.requestedFrequency);
+        
+        cut.designedFrequency = cut.requestedFrequency;
+        cut.fadePosition = 0;
+    }
+    
+    const auto numSamples = block.getNumSamples();
+    const auto numChannels = juce::jmin(block.getNumChannels(), cut.histories.size());
+    const bool fading = cut.fadePosition >= 0;
+    const auto* kernel = cut.kernels[cut.activeKernel].data();
+    const auto* nextKernel = cut.kernels[1 - cut.activeKernel].data();
+    const auto fadeStep = SampleType(1) / static_cast<SampleType>(kernelFadeSamples);
+    
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = block.getChannelPointer(channel);
+        auto* history = cut.histories[channel].data();
+        auto position = cut.historyPositions[channel];
+        
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            // Newest input first, written twice so recent[0..kernelLength) never wraps
+            position = (position == 0 ? kernelLength : position) - 1;
+            history[position] = history[position + kernelLength] = samples[i];
+            const auto* recent = history + position;
+            
+            SampleType output = 0;
+            
+            for (size_t tap = 0; tap < kernelLength; ++tap)
+                output += kernel[tap] * recent[tap];
+            
+            if (fading)
+            {
+                SampleType nextOutput = 0;
+                
+                for (size_t tap = 0; tap < kernelLength; ++tap)
+                    nextOutput += nextKernel[tap] * recent[tap];
+                
+                const auto fade = juce::jmin(SampleType(1), static_cast<SampleType>(cut.fadePosition + static_cast<int>(i) + 1) * fadeStep);
+                output += (nextOutput - output) * fade;
+            }
+            
+            samples[i] = output;
+        }
+        
+        cut.historyPositions[channel] = position;
+    }
+    
+    if (fading)
+    {
+        cut.fadePosition += static_cast<int>(numSamples);
+        
+        if (cut.fadePosition >= kernelFadeSamples)
+        {
+            cut.activeKernel = 1 - cut.activeKernel;
+            cut.fadePosition = -1;
+        }
     }
 }
 
-void LinearPhaseFilters::updateLowCutFilter()
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::designLowCutKernel(SampleType* coefficients, float frequency) const
 {
+    const Trace::ScopedEvent trace("Low-cut coefficients");
+    
     // Create linear phase high-pass FIR filter
-    std::vector<float> coefficients(filterOrder + 1);
+    int center = static_cast<int>(filterOrder / 2);
+    
+    // At the bottom of the range the cut is off: a unit impulse at the centre tap only delays
+    if (frequency <= 20.0f)
+    {
+        std::fill(coefficients, coefficients + kernelLength, SampleType(0));
+        coefficients[center] = SampleType(1);
+        return;
+    }
     
     // Calculate normalized cutoff frequency
-    float normalizedFreq = lowCutFreq / sampleRate;
+    float normalizedFreq = frequency / sampleRate;
     
     // Generate windowed sinc high-pass filter
-    int center = static_cast<int>(filterOrder / 2);
-    
     for (int i = 0; i <= static_cast<int>(filterOrder); ++i)
     {
         int n = i - center;
         
         if (n == 0)
         {
-            coefficients[i] = 1.0f - 2.0f * normalizedFreq;
+            coefficients[i] = static_cast<SampleType>(1.0f - 2.0f * normalizedFreq);
         }
         else
         {
@@ -83,36 +225,39 @@ void LinearPhaseFilters::updateLowCutFilter()
         }
         
         // Apply Blackman window for better frequency response
-        float window = 0.42f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * i / filterOrder) + 
+        float window = 0.42f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * i / filterOrder) +
                       0.08f * std::cos(4.0f * juce::MathConstants<float>::pi * i / filterOrder);
         coefficients[i] *= window;
     }
-    
-    // Apply coefficients to all filters
-    for (auto& filter : lowCutFilters)
-    {
-        *filter.coefficients = juce::dsp::FIR::Coefficients<float>::makeHighPass(sampleRate, lowCutFreq);
-    }
 }
 
-void LinearPhaseFilters::updateHighCutFilter()
+template <typename SampleType>
+void LinearPhaseFilters<SampleType>::designHighCutKernel(SampleType* coefficients, float frequency) const
 {
+    const Trace::ScopedEvent trace("High-cut coefficients");
+    
     // Create linear phase low-pass FIR filter
-    std::vector<float> coefficients(filterOrder + 1);
+    int center = static_cast<int>(filterOrder / 2);
+    
+    // Likewise at the top of the range
+    if (frequency >= 20000.0f)
+    {
+        std::fill(coefficients, coefficients + kernelLength, SampleType(0));
+        coefficients[center] = SampleType(1);
+        return;
+    }
     
     // Calculate normalized cutoff frequency
-    float normalizedFreq = highCutFreq / sampleRate;
+    float normalizedFreq = frequency / sampleRate;
     
     // Generate windowed sinc low-pass filter
-    int center = static_cast<int>(filterOrder / 2);
-    
     for (int i = 0; i <= static_cast<int>(filterOrder); ++i)
     {
         int n = i - center;
         
         if (n == 0)
         {
-            coefficients[i] = 2.0f * normalizedFreq;
+            coefficients[i] = static_cast<SampleType>(2.0f * normalizedFreq);
         }
         else
         {
@@ -122,14 +267,31 @@ void LinearPhaseFilters::updateHighCutFilter()
         }
         
         // Apply Blackman window (ModifiedBesselI0 removed in JUCE 8.0.8)
-        float window = 0.42f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * i / filterOrder) + 
+        float window = 0.42f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * i / filterOrder) +
                       0.08f * std::cos(4.0f * juce::MathConstants<float>::pi * i / filterOrder);
         coefficients[i] *= window;
     }
+}
+
+template <typename SampleType>
+size_t LinearPhaseFilters<SampleType>::getMemoryUsage() const
+{
+    // Two kernels per cut, plus the mirrored input history of each channel
+    size_t bytes = 0;
     
-    // Apply coefficients to all filters
-    for (auto& filter : highCutFilters)
+    for (const auto* cut : { &lowCutState, &highCutState })
     {
-        *filter.coefficients = juce::dsp::FIR::Coefficients<float>::makeLowPass(sampleRate, highCutFreq);
+        for (const auto& kernel : cut->kernels)
+            bytes += MemoryFootprint::bytesOf(kernel);
+        
+        for (const auto& history : cut->histories)
+            bytes += MemoryFootprint::bytesOf(history);
+        
+        bytes += MemoryFootprint::bytesOf(cut->histories) + MemoryFootprint::bytesOf(cut->historyPositions);
     }
+    
+    return bytes;
 }
+
+template class LinearPhaseFilters<float>;
+template class LinearPhaseFilters<double>;
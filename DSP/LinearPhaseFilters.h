@@ -2,63 +2,99 @@
 
 #include <JuceHeader.h>
 
+template <typename SampleType>
 class LinearPhaseFilters
 {
 public:
-    LinearPhaseFilters();
+    // The cuts a section provides. While the section is enabled, each of them always runs,
+    // as a pure delay at the end of its range (20 Hz or 20 kHz), so the latency stays put
+    // when a cutoff is automated across that point.
+    enum Cuts
+    {
+        lowCut = 1,
+        highCut = 2,
+        lowAndHighCut = lowCut | highCut
+    };
+    
+    explicit LinearPhaseFilters(int cutsToUse = lowAndHighCut);
     ~LinearPhaseFilters() = default;
-
+    
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
     
+    // New cutoffs take effect in process(), crossfading from the previous kernel
     void setEnabled(bool enabled);
     void setLowCutFrequency(float frequency);
     void setHighCutFrequency(float frequency);
     
     template<typename ProcessContext>
     void process(const ProcessContext& context);
+    
+    // Group delay of the active filters, and samples until the output falls silent after the input does
+    double getLatencySamples() const;
+    int getTailLengthSamples() const;
+    
+    // Heap memory allocated by prepare(), in bytes (see MemoryFootprint)
+    size_t getMemoryUsage() const;
 
 private:
-    void updateLowCutFilter();
-    void updateHighCutFilter();
+    // High order for linear phase. Even, so the kernel is symmetric about a whole tap
+    static constexpr size_t filterOrder = 512;
+    static constexpr size_t kernelLength = filterOrder + 1;
+    
+    // A new kernel fades in over this long. While a cutoff keeps moving, kernels are
+    // redesigned once per fade rather than per automation step.
+    static constexpr double kernelFadeSeconds = 0.01;
+    
+    // One cut: the kernel in use and, during a fade, the one replacing it. Channels
+    // share the kernels and keep their own input history, mirrored so that the last
+    // kernelLength inputs are always contiguous.
+    struct Cut
+    {
+        std::array<std::vector<SampleType>, 2> kernels;
+        size_t activeKernel = 0;
+        int fadePosition = -1; // samples into the fade, -1 when not fading
+        
+        float designedFrequency = 0.0f;
+        float requestedFrequency = 0.0f;
+        
+        std::vector<std::vector<SampleType>> histories;
+        std::vector<size_t> historyPositions;
+    };
     
-    // Linear phase FIR filters
-    juce::dsp::FIR::Filter<float> lowCutFilter;
-    juce::dsp::FIR::Filter<float> highCutFilter;
+    void prepareCut(Cut& cut, size_t numChannels, float frequency, bool highPass);
+    void processCut(Cut& cut, juce::dsp::AudioBlock<SampleType>& block, bool highPass);
+    void designLowCutKernel(SampleType* coefficients, float frequency) const;
+    void designHighCutKernel(SampleType* coefficients, float frequency) const;
+    int getNumActiveFilters() const;
+    bool usesCut(Cuts cut) const { return (cuts & cut) != 0; }
     
+    int cuts = lowAndHighCut;
     bool enabled = true;
     float lowCutFreq = 20.0f;
     float highCutFreq = 20000.0f;
     float sampleRate = 44100.0f;
+    int kernelFadeSamples = 1;
     
-    static constexpr size_t filterOrder = 511; // High order for linear phase
-    static constexpr size_t numChannels = 2;
-    
-    std::array<juce::dsp::FIR::Filter<float>, numChannels> lowCutFilters;
-    std::array<juce::dsp::FIR::Filter<float>, numChannels> highCutFilters;
+    Cut lowCutState;
+    Cut highCutState;
 };
 
-template<typename ProcessContext>
-void LinearPhaseFilters::process(const ProcessContext& context)
+template <typename SampleType>
+template <typename ProcessContext>
+void LinearPhaseFilters<SampleType>::process(const ProcessContext& context)
 {
     if (!enabled)
         return;
-        
+    
     auto& outputBlock = context.getOutputBlock();
-    const auto numChannelsToProcess = outputBlock.getNumChannels();
+    jassert(outputBlock.getNumChannels() <= juce::jmax(lowCutState.histories.size(), highCutState.histories.size()));
     
-    // Process each channel
-    for (size_t channel = 0; channel < numChannelsToProcess && channel < numChannels; ++channel)
-    {
-        auto channelBlock = outputBlock.getSingleChannelBlock(channel);
-        juce::dsp::ProcessContextReplacing<float> channelContext(channelBlock);
-        
-        // Apply low cut filter
-        if (lowCutFreq > 20.0f)
-            lowCutFilters[channel].process(channelContext);
-        
-        // Apply high cut filter  
-        if (highCutFreq < 20000.0f)
-            highCutFilters[channel].process(channelContext);
-    }
+    // Apply low cut filter
+    if (usesCut(lowCut))
+        processCut(lowCutState, outputBlock, false);
+    
+    // Apply high cut filter
+    if (usesCut(highCut))
+        processCut(highCutState, outputBlock, true);
 }
@@ -0,0 +1,86 @@
+#include "LinkwitzRileyCrossover.h"
+
+template <typename SampleType>
+LinkwitzRileyCrossover<SampleType>::LinkwitzRileyCrossover()
+{
+    for (auto& splitter : splitters)
+        splitter.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+    
+    for (auto& row : compensation)
+        for (auto& filter : row)
+            filter.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+}
+
+template <typename SampleType>
+void LinkwitzRileyCrossover<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    
+    for (auto& splitter : splitters)
+        splitter.prepare(spec);
+    
+    for (auto& row : compensation)
+        for (auto& filter : row)
+            filter.prepare(spec);
+    
+    updateFrequencies();
+    reset();
+}
+
+template <typename SampleType>
+void LinkwitzRileyCrossover<SampleType>::reset()
+{
+    for (auto& splitter : splitters)
+        splitter.reset();
+    
+    for (auto& row : compensation)
+        for (auto& filter : row)
+            filter.reset();
+}
+
+template <typename SampleType>
+void LinkwitzRileyCrossover<SampleType>::setNumBands(int bands)
+{
+    bands = juce::jlimit(1, maxBands, bands);
+    
+    if (bands != numBands)
+    {
+        numBands = bands;
+        reset();
+    }
+}
+
+template <typename SampleType>
+void LinkwitzRileyCrossover<SampleType>::setCrossoverFrequency(int index, float frequency)
+{
+    if (index < 0 || index >= maxCrossovers)
+        return;
+    
+    if (std::abs(frequencies[static_cast<size_t>(index)] - frequency) > 0.1f)
+    {
+        frequencies[static_cast<size_t>(index)] = frequency;
+        updateFrequencies();
+    }
+}
+
+template <typename SampleType>
+void LinkwitzRileyCrossover<SampleType>::updateFrequencies()
+{
+    // Keep crossovers ascending and below Nyquist
+    const auto nyquistLimit = static_cast<float>(sampleRate * 0.45);
+    float previous = 20.0f;
+    
+    for (size_t crossover = 0; crossover < static_cast<size_t>(maxCrossovers); ++crossover)
+    {
+        const auto frequency = juce::jlimit(previous, nyquistLimit, frequencies[crossover]);
+        previous = frequency;
+        
+        splitters[crossover].setCutoffFrequency(static_cast<SampleType>(frequency));
+        
+        for (auto& filter : compensation[crossover])
+            filter.setCutoffFrequency(static_cast<SampleType>(frequency));
+    }
+}
+
+template class LinkwitzRileyCrossover<float>;
+template class LinkwitzRileyCrossover<double>;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Splits a signal into up to four bands with 4th-order Linkwitz-Riley
+// crossovers. Lower bands are passed through the all-pass response of every
+// crossover above them, so all bands share the same phase and their sum is
+// magnitude-flat.
+template <typename SampleType>
+class LinkwitzRileyCrossover
+{
+public:
+    static constexpr int maxBands = 4;
+    using Bands = std::array<SampleType, maxBands>;
+    
+    LinkwitzRileyCrossover();
+    ~LinkwitzRileyCrossover() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    
+    void setNumBands(int bands);
+    int getNumBands() const { return numBands; }
+    
+    // Crossover index 0 sits between bands 0 and 1, and so on
+    void setCrossoverFrequency(int index, float frequency);
+    
+    // Splits one sample of one channel into getNumBands() bands
+    void processSample(int channel, SampleType input, Bands& bands) noexcept;
+
+private:
+    void updateFrequencies();
+    
+    static constexpr int maxCrossovers = maxBands - 1;
+    
+    std::array<juce::dsp::LinkwitzRileyFilter<SampleType>, maxCrossovers> splitters;
+    
+    // compensation[k][j]: all-pass of crossover k applied to band j (j < k)
+    std::array<std::array<juce::dsp::LinkwitzRileyFilter<SampleType>, maxCrossovers>, maxCrossovers> compensation;
+    
+    std::array<float, maxCrossovers> frequencies { 120.0f, 1000.0f, 6000.0f };
+    int numBands = 1;
+    double sampleRate = 44100.0;
+};
+
+template <typename SampleType>
+void LinkwitzRileyCrossover<SampleType>::processSample(int channel, SampleType input, Bands& bands) noexcept
+{
+    SampleType remainder = input;
+    
+    for (int crossover = 0; crossover < numBands - 1; ++crossover)
+    {
+        SampleType low, high;
+        splitters[static_cast<size_t>(crossover)].processSample(channel, remainder, low, high);
+        
+        // Keep the bands already split off in phase with this crossover
+        for (int band = 0; band < crossover; ++band)
+            bands[static_cast<size_t>(band)] = compensation[static_cast<size_t>(crossover)][static_cast<size_t>(band)]
+                                                   .processSample(channel, bands[static_cast<size_t>(band)]);
+        
+        bands[static_cast<size_t>(crossover)] = low;
+        remainder = high;
+    }
+    
+    bands[static_cast<size_t>(numBands - 1)] = remainder;
+}
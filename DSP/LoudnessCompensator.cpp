@@ -1,24 +1,18 @@
 #include "LoudnessCompensator.h"
+#include "MemoryFootprint.h"
 
-LoudnessCompensator::LoudnessCompensator()
+template <typename SampleType>
+LoudnessCompensator<SampleType>::LoudnessCompensator()
 {
-    gainSmoother.setAttackTime(50.0f);  // 50ms attack
-    gainSmoother.setReleaseTime(200.0f); // 200ms release
+    gainSmoother.setAttackTime(SampleType(50));  // 50ms attack
+    gainSmoother.setReleaseTime(SampleType(200)); // 200ms release
 }
 
-void LoudnessCompensator::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void LoudnessCompensator<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = static_cast<float>(spec.sampleRate);
     
-    // Initialize K-weighting filters for each channel
-    kWeightingFilters.clear();
-    kWeightingFilters.resize(spec.numChannels);
-    
-    for (auto& filter : kWeightingFilters)
-    {
-        filter.prepare(spec);
-    }
-    
     gainSmoother.prepare(spec);
     
     // Initialize loudness buffers
@@ -29,13 +23,9 @@ void LoudnessCompensator::prepare(const juce::dsp::ProcessSpec& spec)
     reset();
 }
 
-void LoudnessCompensator::reset()
+template <typename SampleType>
+void LoudnessCompensator<SampleType>::reset()
 {
-    for (auto& filter : kWeightingFilters)
-    {
-        filter.reset();
-    }
-    
     gainSmoother.reset();
     
     std::fill(inputLoudnessBuffer.begin(), inputLoudnessBuffer.end(), 0.0f);
@@ -49,9 +39,10 @@ void LoudnessCompensator::reset()
     compensationGain = 0.0f;
 }
 
-void LoudnessCompensator::analyzeInput(const juce::dsp::AudioBlock<const float>& inputBlock)
+template <typename SampleType>
+void LoudnessCompensator<SampleType>::analyzeInput(const LevelMeter<SampleType>& inputMeter)
 {
-    calculateLoudness(inputBlock, inputLoudness);
+    calculateLoudness(inputMeter, inputLoudness);
     
     // Store reference loudness when first analyzing input
     if (!buffersInitialized)
@@ -60,9 +51,10 @@ void LoudnessCompensator::analyzeInput(const juce::dsp::AudioBlock<const float>&
     }
 }
 
-void LoudnessCompensator::analyzeOutput(const juce::dsp::AudioBlock<const float>& outputBlock)
+template <typename SampleType>
+void LoudnessCompensator<SampleType>::analyzeOutput(const LevelMeter<SampleType>& outputMeter)
 {
-    calculateLoudness(outputBlock, outputLoudness);
+    calculateLoudness(outputMeter, outputLoudness);
     
     // Calculate compensation gain
     if (outputLoudness > 0.001f && targetLoudness > 0.001f)
@@ -77,16 +69,27 @@ void LoudnessCompensator::analyzeOutput(const juce::dsp::AudioBlock<const float>
     }
 }
 
-float LoudnessCompensator::getCompensationGain() const
+template <typename SampleType>
+float LoudnessCompensator<SampleType>::getCompensationGain() const
 {
     return compensationGain;
 }
 
-void LoudnessCompensator::applyCompensation(juce::dsp::AudioBlock<float>& block)
+template <typename SampleType>
+float LoudnessCompensator<SampleType>::getAppliedGain() const
+{
+    // Linear gain applyCompensation() is heading towards
+    if (std::abs(compensationGain) > 0.1f)
+        return juce::Decibels::decibelsToGain(compensationGain);
+    return 1.0f;
+}
+
+template <typename SampleType>
+void LoudnessCompensator<SampleType>::applyCompensation(juce::dsp::AudioBlock<SampleType>& block)
 {
     if (std::abs(compensationGain) > 0.1f)
     {
-        float linearGain = juce::Decibels::decibelsToGain(compensationGain);
+        const auto linearGain = juce::Decibels::decibelsToGain(static_cast<SampleType>(compensationGain));
         
         // Apply smoothed gain
         for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
@@ -94,45 +97,27 @@ void LoudnessCompensator::applyCompensation(juce::dsp::AudioBlock<float>& block)
             auto* channelData = block.getChannelPointer(channel);
             for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
             {
-                float smoothedGain = gainSmoother.processSample(static_cast<int>(channel), linearGain);
+                SampleType smoothedGain = gainSmoother.processSample(static_cast<int>(channel), linearGain);
                 channelData[sample] *= smoothedGain;
             }
         }
     }
 }
 
-void LoudnessCompensator::calculateLoudness(const juce::dsp::AudioBlock<const float>& block, float& loudnessTarget)
+template <typename SampleType>
+void LoudnessCompensator<SampleType>::calculateLoudness(const LevelMeter<SampleType>& meter, float& loudnessTarget)
 {
-    float rms = calculateRMS(block);
-    float peak = calculatePeak(block);
+    float rms = meter.getBlockRMS();
+    float peak = meter.getBlockPeak();
     float crestFactor = calculateCrestFactor(rms, peak);
     
     // Perceptual loudness weighting (simplified)
     // Accounts for frequency weighting and dynamic range
     float perceptualLoudness = rms * (1.0f + crestFactor * 0.3f);
     
-    // Apply K-weighting approximation
-    if (!kWeightingFilters.empty())
-    {
-        float weightedSum = 0.0f;
-        size_t sampleCount = 0;
-        
-        for (size_t channel = 0; channel < block.getNumChannels() && channel < kWeightingFilters.size(); ++channel)
-        {
-            for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
-            {
-                float inputSample = block.getSample(static_cast<int>(channel), static_cast<int>(sample));
-                float weighted = kWeightingFilters[channel].process(inputSample);
-                weightedSum += weighted * weighted;
-                sampleCount++;
-            }
-        }
-        
-        if (sampleCount > 0)
-        {
-            perceptualLoudness = std::sqrt(weightedSum / sampleCount);
-        }
-    }
+    // Prefer the K-weighting approximation gathered by the meter
+    if (meter.getNumChannels() > 0)
+        perceptualLoudness = meter.getKWeightedRMS();
     
     // Smooth the loudness measurement
     loudnessTarget = loudnessTarget * smoothingCoeff + perceptualLoudness * (1.0f - smoothingCoeff);
@@ -155,74 +140,19 @@ void LoudnessCompensator::calculateLoudness(const juce::dsp::AudioBlock<const fl
     }
 }
 
-float LoudnessCompensator::calculateRMS(const juce::dsp::AudioBlock<const float>& block)
-{
-    float sum = 0.0f;
-    size_t sampleCount = 0;
-    
-    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
-    {
-        for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
-        {
-            float sampleValue = block.getSample(static_cast<int>(channel), static_cast<int>(sample));
-            sum += sampleValue * sampleValue;
-            sampleCount++;
-        }
-    }
-    
-    return sampleCount > 0 ? std::sqrt(sum / sampleCount) : 0.0f;
-}
-
-float LoudnessCompensator::calculatePeak(const juce::dsp::AudioBlock<const float>& block)
-{
-    float peak = 0.0f;
-    
-    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
-    {
-        for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
-        {
-            float sampleValue = std::abs(block.getSample(static_cast<int>(channel), static_cast<int>(sample)));
-            peak = juce::jmax(peak, sampleValue);
-        }
-    }
-    
-    return peak;
-}
-
-float LoudnessCompensator::calculateCrestFactor(float rms, float peak)
+template <typename SampleType>
+float LoudnessCompensator<SampleType>::calculateCrestFactor(float rms, float peak)
 {
     if (rms > 0.0001f)
         return peak / rms;
     return 1.0f;
 }
 
-// K-weighting filter implementation
-void LoudnessCompensator::KWeightingFilter::prepare(const juce::dsp::ProcessSpec& spec)
-{
-    // Approximate K-weighting with high shelf + high pass
-    // High shelf at ~4kHz (+4dB)
-    auto highShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        spec.sampleRate, 4000.0f, 0.7f, juce::Decibels::decibelsToGain(4.0f));
-    highShelf.coefficients = highShelfCoeffs;
-    
-    // High pass at ~38Hz
-    auto highPassCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(
-        spec.sampleRate, 38.0f, 0.5f);
-    highPass.coefficients = highPassCoeffs;
-    
-    highShelf.prepare(spec);
-    highPass.prepare(spec);
-}
-
-void LoudnessCompensator::KWeightingFilter::reset()
+template <typename SampleType>
+size_t LoudnessCompensator<SampleType>::getMemoryUsage() const
 {
-    highShelf.reset();
-    highPass.reset();
+    return MemoryFootprint::bytesOf(inputLoudnessBuffer) + MemoryFootprint::bytesOf(outputLoudnessBuffer);
 }
 
-float LoudnessCompensator::KWeightingFilter::process(float sample)
-{
-    float filtered = highPass.processSample(sample);
-    filtered = highShelf.processSample(filtered);
-    return filtered;
-}
+template class LoudnessCompensator<float>;
+template class LoudnessCompensator<double>;
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "LevelMeter.h"
 
+template <typename SampleType>
 class LoudnessCompensator
 {
 public:
@@ -11,34 +13,25 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
     
-    void analyzeInput(const juce::dsp::AudioBlock<const float>& inputBlock);
-    void analyzeOutput(const juce::dsp::AudioBlock<const float>& outputBlock);
+    // Meters must already have processed the current block
+    void analyzeInput(const LevelMeter<SampleType>& inputMeter);
+    void analyzeOutput(const LevelMeter<SampleType>& outputMeter);
     
     float getCompensationGain() const;
-    void applyCompensation(juce::dsp::AudioBlock<float>& block);
+    float getAppliedGain() const;
+    void applyCompensation(juce::dsp::AudioBlock<SampleType>& block);
     
     // Get current loudness measurements
     float getInputLoudness() const { return inputLoudness; }
     float getOutputLoudness() const { return outputLoudness; }
+    
+    // Heap memory allocated by prepare(), in bytes (see MemoryFootprint)
+    size_t getMemoryUsage() const;
 
 private:
-    void calculateLoudness(const juce::dsp::AudioBlock<const float>& block, float& loudnessTarget);
-    float calculateRMS(const juce::dsp::AudioBlock<const float>& block);
-    float calculatePeak(const juce::dsp::AudioBlock<const float>& block);
+    void calculateLoudness(const LevelMeter<SampleType>& meter, float& loudnessTarget);
     float calculateCrestFactor(float rms, float peak);
     
-    // K-weighted filters for loudness measurement (approximation)
-    struct KWeightingFilter
-    {
-        juce::dsp::IIR::Filter<float> highShelf;
-        juce::dsp::IIR::Filter<float> highPass;
-        void prepare(const juce::dsp::ProcessSpec& spec);
-        void reset();
-        float process(float sample);
-    };
-    
-    std::vector<KWeightingFilter> kWeightingFilters;
-    
     float sampleRate = 44100.0f;
     
     // Loudness measurements
@@ -58,5 +51,5 @@ private:
     bool buffersInitialized = false;
     
     // Gain smoothing
-    juce::dsp::BallisticsFilter<float> gainSmoother;
+    juce::dsp::BallisticsFilter<SampleType> gainSmoother;
 };
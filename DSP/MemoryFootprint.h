@@ -0,0 +1,92 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Heap memory owned by one plugin instance, in bytes per module. Modules report what
+// they allocated when prepared, from container capacities; buffers hidden inside JUCE
+// classes (oversampling stages, dry/wet mixer) are estimated from the sizes
+// those were prepared with. Tables shared through SharedResourceCache belong to no
+// single instance and are not counted.
+class MemoryFootprint
+{
+public:
+    struct Entry
+    {
+        juce::String module;
+        size_t bytes = 0;
+    };
+    
+    // Reports under an existing name add up, e.g. one per lane or per precision chain
+    void add(const juce::String& module, size_t bytes)
+    {
+        for (auto& entry : entries)
+        {
+            if (entry.module == module)
+            {
+                entry.bytes += bytes;
+                return;
+            }
+        }
+        
+        entries.push_back({ module, bytes });
+    }
+    
+    const std::vector<Entry>& getEntries() const noexcept { return entries; }
+    
+    size_t getBytes(const juce::String& module) const noexcept
+    {
+        for (const auto& entry : entries)
+            if (entry.module == module)
+                return entry.bytes;
+        
+        return 0;
+    }
+    
+    size_t getTotalBytes() const noexcept
+    {
+        size_t total = 0;
+        
+        for (const auto& entry : entries)
+            total += entry.bytes;
+        
+        return total;
+    }
+    
+    // One line per module and a total, largest first; for logs and debug dumps
+    juce::String toString() const
+    {
+        auto sorted = entries;
+        std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) { return a.bytes > b.bytes; });
+        
+        juce::String text;
+        
+        for (const auto& entry : sorted)
+            text << entry.module.paddedRight(' ', 28) << formatBytes(entry.bytes).paddedLeft(' ', 12) << juce::newLine;
+        
+        text << juce::String("Total").paddedRight(' ', 28) << formatBytes(getTotalBytes()).paddedLeft(' ', 12) << juce::newLine;
+        return text;
+    }
+    
+    static juce::String formatBytes(size_t bytes)
+    {
+        if (bytes >= 1024 * 1024)
+            return juce::String(static_cast<double>(bytes) / (1024.0 * 1024.0), 2) + " MB";
+        
+        return juce::String(static_cast<double>(bytes) / 1024.0, 1) + " KB";
+    }
+    
+    template <typename Type>
+    static size_t bytesOf(const std::vector<Type>& vector) noexcept
+    {
+        return vector.capacity() * sizeof(Type);
+    }
+    
+    template <typename Type>
+    static size_t bytesOf(const juce::AudioBuffer<Type>& buffer) noexcept
+    {
+        return static_cast<size_t>(buffer.getNumChannels()) * static_cast<size_t>(buffer.getNumSamples()) * sizeof(Type);
+    }
+
+private:
+    std::vector<Entry> entries;
+};
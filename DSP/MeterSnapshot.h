@@ -0,0 +1,94 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "StageProfiler.h"
+
+// One consistent set of meter readings, published by the audio thread once per block
+struct MeterFrame
+{
+    // Enough for 7.1.4 (12 channels) with room for 9.1.6
+    static constexpr size_t maxChannels = 16;
+
+    std::array<float, maxChannels> inputRMS {};
+    std::array<float, maxChannels> inputPeak {};
+    std::array<float, maxChannels> outputRMS {};
+    std::array<float, maxChannels> outputPeak {};
+    std::array<float, maxChannels> outputTruePeak {};
+
+    // Levels seen by the saturation stage (after input gain and pre-filters)
+    std::array<float, maxChannels> saturationRMS {};
+    std::array<float, maxChannels> saturationPeak {};
+
+    float inputLUFS = -100.0f;
+    float outputLUFS = -100.0f;
+    float compensationGainDb = 0.0f;
+
+    // CPU load per chain stage in percent of real time, while profiling is enabled
+    std::array<float, StageProfile::numStages> stageAverageLoad {};
+    std::array<float, StageProfile::numStages> stageWorstLoad {};
+    float worstBlockLoad = 0.0f;
+    bool stageProfilingEnabled = false;
+
+    uint32 numChannels = 0;
+};
+
+// Single-writer / multi-reader seqlock around a MeterFrame.
+// The writer never blocks; readers retry if they overlap a publish.
+class MeterSnapshot
+{
+public:
+    MeterSnapshot() = default;
+
+    // Audio thread only
+    void publish(const MeterFrame& newFrame) noexcept
+    {
+        const auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&frame, &newFrame, sizeof(MeterFrame));
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Any thread; leaves result untouched if no consistent frame could be read
+    bool read(MeterFrame& result) const noexcept
+    {
+        MeterFrame candidate;
+
+        for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+        {
+            const auto before = sequence.load(std::memory_order_acquire);
+
+            if ((before & 1) != 0)
+                continue;
+
+            std::memcpy(&candidate, &frame, sizeof(MeterFrame));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence.load(std::memory_order_relaxed) == before)
+            {
+                result = candidate;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static float gainToLUFS(float kWeightedRMS) noexcept
+    {
+        // BS.1770 offset applied to the K-weighted mean square
+        return kWeightedRMS > 0.0f ? -0.691f + 20.0f * std::log10(kWeightedRMS) : -100.0f;
+    }
+
+private:
+    static_assert(std::is_trivially_copyable<MeterFrame>::value, "MeterFrame must be trivially copyable");
+
+    static constexpr int maxReadAttempts = 8;
+
+    std::atomic<uint32> sequence { 0 };
+    MeterFrame frame;
+
+    JUCE_DECLARE_NON_COPYABLE(MeterSnapshot)
+};
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Inference for small recurrent amp/saturator captures: one LSTM or GRU layer
+// (hidden size up to 40) followed by a dense output and an optional input skip,
+// read from the JSON exported by Automated-GuitarAmpModelling style trainers.
+// Header-only. Weights live in compile-time sized, SIMD-aligned arrays and the
+// hidden size is padded up to the next multiple of 8 with zero weights, which
+// leaves the result unchanged. Processing a sample never allocates.
+
+// Recurrent state of one channel, sized for the largest supported model
+template <typename SampleType>
+struct NeuralModelState
+{
+    static constexpr int maxHiddenSize = 40;
+    static constexpr size_t alignment = juce::dsp::SIMDRegister<SampleType>::SIMDRegisterSize;
+    
+    alignas(alignment) std::array<SampleType, maxHiddenSize> hidden {};
+    alignas(alignment) std::array<SampleType, maxHiddenSize> cell {}; // LSTM only
+};
+
+template <typename SampleType>
+class NeuralAmpModel
+{
+public:
+    enum CellType
+    {
+        LSTM,
+        GRU
+    };
+    
+    virtual ~NeuralAmpModel() = default;
+    
+    virtual SampleType processSample(SampleType input, NeuralModelState<SampleType>& state) const noexcept = 0;
+    
+    CellType getCellType() const noexcept { return cellType; }
+    int getHiddenSize() const noexcept { return hiddenSize; }
+    double getSampleRate() const noexcept { return sampleRate; }
+    const juce::String& getName() const noexcept { return name; }
+    
+    // Parse and build a model; call from the message or a background thread, never the audio thread.
+    // Returns nullptr and fills error if the file is not a supported model.
+    static std::unique_ptr<NeuralAmpModel> loadFromJSON(const juce::var& json, juce::String& error);
+    static std::unique_ptr<NeuralAmpModel> loadFromFile(const juce::File& file, juce::String& error);
+
+protected:
+    CellType cellType = LSTM;
+    int hiddenSize = 0;
+    double sampleRate = 48000.0;
+    bool skip = false;
+    juce::String name;
+    
+    static SampleType tanhActivation(SampleType x) noexcept
+    {
+        return juce::dsp::FastMathApproximations::tanh(juce::jlimit(SampleType(-5), SampleType(5), x));
+    }
+    
+    static SampleType sigmoidActivation(SampleType x) noexcept
+    {
+        return SampleType(0.5) + SampleType(0.5) * tanhActivation(SampleType(0.5) * x);
+    }
+    
+    // Flattens a JSON number array (or array of rows) and checks its size
+    static bool readValues(const juce::var& value, size_t expectedSize, std::vector<double>& values)
+    {
+        values.clear();
+        
+        if (auto* outer = value.getArray())
+        {
+            for (const auto& element : *outer)
+            {
+                if (auto* row = element.getArray())
+                    for (const auto& item : *row)
+                        values.push_back(static_cast<double>(item));
+                else
+                    values.push_back(static_cast<double>(element));
+            }
+        }
+        
+        return values.size() == expectedSize;
+    }
+};
+
+template <typename SampleType, int Capacity, bool IsLSTM>
+class RecurrentNeuralModel : public NeuralAmpModel<SampleType>
+{
+public:
+    static_assert(Capacity % 8 == 0 && Capacity <= NeuralModelState<SampleType>::maxHiddenSize, "Unsupported hidden size");
+    
+    static constexpr size_t numGates = IsLSTM ? 4 : 3;
+    static constexpr size_t gateRows = numGates * static_cast<size_t>(Capacity);
+    
+    // Reads PyTorch weights (gate order i, f, g, o for LSTM; r, z, n for GRU) into the padded layout
+    bool setWeights(const juce::var& stateDict, int modelHiddenSize, juce::String& error)
+    {
+        const auto hidden = static_cast<size_t>(modelHiddenSize);
+        const auto rows = numGates * hidden;
+        std::vector<double> inputW, recurrentW, inputB, recurrentB, outputW, outputB;
+        
+        if (! this->readValues(stateDict["rec.weight_ih_l0"], rows, inputW)
+         || ! this->readValues(stateDict["rec.weight_hh_l0"], rows * hidden, recurrentW)
+         || ! this->readValues(stateDict["rec.bias_ih_l0"], rows, inputB)
+         || ! this->readValues(stateDict["rec.bias_hh_l0"], rows, recurrentB)
+         || ! this->readValues(stateDict["lin.weight"], hidden, outputW)
+         || ! this->readValues(stateDict["lin.bias"], 1, outputB))
+        {
+            error = "Model weights are missing or do not match hidden_size";
+            return false;
+        }
+        
+        for (size_t row = 0; row < rows; ++row)
+        {
+            const auto paddedRow = (row / hidden) * static_cast<size_t>(Capacity) + row % hidden;
+            
+            inputWeights[paddedRow] = static_cast<SampleType>(inputW[row]);
+            inputBias[paddedRow] = static_cast<SampleType>(inputB[row]);
+            recurrentBias[paddedRow] = static_cast<SampleType>(recurrentB[row]);
+            
+            // Column-major, so each hidden unit's contribution is one contiguous vector
+            for (size_t column = 0; column < hidden; ++column)
+                recurrentWeights[column * gateRows + paddedRow] = static_cast<SampleType>(recurrentW[row * hidden + column]);
+        }
+        
+        for (size_t unit = 0; unit < hidden; ++unit)
+            outputWeights[unit] = static_cast<SampleType>(outputW[unit]);
+        
+        outputBias = static_cast<SampleType>(outputB[0]);
+        return true;
+    }
+    
+    SampleType processSample(SampleType input, NeuralModelState<SampleType>& state) const noexcept override
+    {
+        constexpr auto capacity = static_cast<size_t>(Capacity);
+        alignas(alignment) std::array<SampleType, gateRows> recurrent;
+        
+        recurrentGates(state.hidden.data(), recurrent.data());
+        
+        if constexpr (IsLSTM)
+        {
+            for (size_t unit = 0; unit < capacity; ++unit)
+            {
+                const auto i = this->sigmoidActivation(inputGate(0, unit, input) + recurrent[unit]);
+                const auto f = this->sigmoidActivation(inputGate(1, unit, input) + recurrent[capacity + unit]);
+                const auto g = this->tanhActivation(inputGate(2, unit, input) + recurrent[2 * capacity + unit]);
+                const auto o = this->sigmoidActivation(inputGate(3, unit, input) + recurrent[3 * capacity + unit]);
+                
+                state.cell[unit] = f * state.cell[unit] + i * g;
+                state.hidden[unit] = o * this->tanhActivation(state.cell[unit]);
+            }
+        }
+        else
+        {
+            for (size_t unit = 0; unit < capacity; ++unit)
+            {
+                const auto r = this->sigmoidActivation(inputGate(0, unit, input) + recurrent[unit]);
+                const auto z = this->sigmoidActivation(inputGate(1, unit, input) + recurrent[capacity + unit]);
+                const auto n = this->tanhActivation(inputGate(2, unit, input) + r * recurrent[2 * capacity + unit]);
+                
+                state.hidden[unit] = n + z * (state.hidden[unit] - n);
+            }
+        }
+        
+        SampleType output = outputBias;
+        
+        for (size_t unit = 0; unit < capacity; ++unit)
+            output += outputWeights[unit] * state.hidden[unit];
+        
+        return this->skip ? output + input : output;
+    }
+
+private:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr size_t alignment = Register::SIMDRegisterSize;
+    static_assert(gateRows % Register::SIMDNumElements == 0, "Gate rows must fill whole registers");
+    
+    SampleType inputGate(size_t gate, size_t unit, SampleType input) const noexcept
+    {
+        const auto row = gate * static_cast<size_t>(Capacity) + unit;
+        return inputWeights[row] * input + inputBias[row];
+    }
+    
+    // recurrent = W_hh * hidden + b_hh, one register of gate rows at a time
+    void recurrentGates(const SampleType* hidden, SampleType* recurrent) const noexcept
+    {
+        for (size_t row = 0; row < gateRows; row += Register::SIMDNumElements)
+        {
+            auto accumulator = Register::fromRawArray(recurrentBias.data() + row);
+            
+            for (size_t column = 0; column < static_cast<size_t>(Capacity); ++column)
+                accumulator += Register::fromRawArray(recurrentWeights.data() + column * gateRows + row) * Register::expand(hidden[column]);
+            
+            accumulator.copyToRawArray(recurrent + row);
+        }
+    }
+    
+    alignas(alignment) std::array<SampleType, gateRows> inputWeights {};
+    alignas(alignment) std::array<SampleType, gateRows> inputBias {};
+    alignas(alignment) std::array<SampleType, gateRows> recurrentBias {};
+    alignas(alignment) std::array<SampleType, gateRows * static_cast<size_t>(Capacity)> recurrentWeights {};
+    alignas(alignment) std::array<SampleType, static_cast<size_t>(Capacity)> outputWeights {};
+    SampleType outputBias = 0;
+};
+
+template <typename SampleType>
+std::unique_ptr<NeuralAmpModel<SampleType>> NeuralAmpModel<SampleType>::loadFromJSON(const juce::var& json, juce::String& error)
+{
+    const auto& modelData = json["model_data"];
+    const auto& stateDict = json["state_dict"];
+    
+    if (! modelData.isObject() || ! stateDict.isObject())
+    {
+        error = "Not a recurrent model file (model_data / state_dict missing)";
+        return nullptr;
+    }
+    
+    const auto unitType = modelData["unit_type"].toString().toUpperCase();
+    const int hidden = modelData["hidden_size"];
+    const int inputSize = modelData.hasProperty("input_size") ? static_cast<int>(modelData["input_size"]) : 1;
+    const int outputSize = modelData.hasProperty("output_size") ? static_cast<int>(modelData["output_size"]) : 1;
+    const int numLayers = modelData.hasProperty("num_layers") ? static_cast<int>(modelData["num_layers"]) : 1;
+    
+    if (unitType != "LSTM" && unitType != "GRU")
+    {
+        error = "Unsupported unit_type '" + unitType + "' (LSTM or GRU expected)";
+        return nullptr;
+    }
+    
+    if (hidden < 1 || hidden > NeuralModelState<SampleType>::maxHiddenSize || inputSize != 1 || outputSize != 1 || numLayers != 1)
+    {
+        error = "Only single-layer, mono in/out models with hidden_size 1-"
+              + juce::String(NeuralModelState<SampleType>::maxHiddenSize) + " are supported";
+        return nullptr;
+    }
+    
+    // Pick the smallest compile-time size that fits
+    const bool isLSTM = unitType == "LSTM";
+    std::unique_ptr<NeuralAmpModel> model;
+    bool loaded = false;
+    
+    const auto create = [&](auto typedModel)
+    {
+        loaded = typedModel->setWeights(stateDict, hidden, error);
+        model = std::move(typedModel);
+    };
+    
+    const auto createWithCapacity = [&](auto capacity)
+    {
+        constexpr int size = decltype(capacity)::value;
+        
+        if (isLSTM)
+            create(std::make_unique<RecurrentNeuralModel<SampleType, size, true>>());
+        else
+            create(std::make_unique<RecurrentNeuralModel<SampleType, size, false>>());
+    };
+    
+    if (hidden <= 8)
+        createWithCapacity(std::integral_constant<int, 8>());
+    else if (hidden <= 16)
+        createWithCapacity(std::integral_constant<int, 16>());
+    else if (hidden <= 24)
+        createWithCapacity(std::integral_constant<int, 24>());
+    else if (hidden <= 32)
+        createWithCapacity(std::integral_constant<int, 32>());
+    else
+        createWithCapacity(std::integral_constant<int, 40>());
+    
+    if (! loaded)
+        return nullptr;
+    
+    model->cellType = isLSTM ? LSTM : GRU;
+    model->hiddenSize = hidden;
+    model->skip = static_cast<int>(modelData.getProperty("skip", 0)) != 0;
+    
+    // Trainers disagree on the key; 48 kHz is the common default
+    const auto rate = static_cast<double>(modelData.getProperty("sample_rate", modelData.getProperty("samplerate", 48000.0)));
+    model->sampleRate = rate > 0.0 ? rate : 48000.0;
+    model->name = modelData.getProperty("name", {}).toString();
+    
+    return model;
+}
+
+template <typename SampleType>
+std::unique_ptr<NeuralAmpModel<SampleType>> NeuralAmpModel<SampleType>::loadFromFile(const juce::File& file, juce::String& error)
+{
+    if (! file.existsAsFile())
+    {
+        error = "Model file not found: " + file.getFullPathName();
+        return nullptr;
+    }
+    
+    juce::var json;
+    const auto result = juce::JSON::parse(file.loadFileAsString(), json);
+    
+    if (result.failed())
+    {
+        error = "Invalid JSON: " + result.getErrorMessage();
+        return nullptr;
+    }
+    
+    auto model = loadFromJSON(json, error);
+    
+    if (model != nullptr && model->name.isEmpty())
+        model->name = file.getFileNameWithoutExtension();
+    
+    return model;
+}
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SaturationProcessor.h"
+#include "AdaptiveEqualizer.h"
+#include "LinearPhaseFilters.h"
+#include "LoudnessCompensator.h"
+#include "LevelMeter.h"
+#include "LatencyCompensatedBypass.h"
+#include "StageProfiler.h"
+#include "MemoryFootprint.h"
+
+// Complete set of DSP modules for one sample precision
+template <typename SampleType>
+struct ProcessingChain
+{
+    static constexpr int maxBands = SaturationProcessor<SampleType>::maxBands;
+    
+    // Continuous parameters. Each host block ramps them from the values the previous
+    // block ended on to the ones read at its start, so automation moves within the
+    // block instead of stepping once per block, whatever the host's buffer size.
+    enum AutomatedParameter
+    {
+        inputGainDb,
+        outputGainDb,
+        drive,
+        mix,
+        sideDrive,
+        lowCutFrequency,
+        highCutFrequency,
+        firstCrossoverFrequency,
+        firstBandDrive = firstCrossoverFrequency + maxBands - 1,
+        firstBandMix = firstBandDrive + maxBands,
+        numAutomatedParameters = firstBandMix + maxBands
+    };
+    
+    struct AutomationRamp
+    {
+        // Called before new targets are written: the previous block ended on the old ones
+        void jumpToEnd() { start = end; }
+        
+        bool isRamping() const { return start != end; }
+        
+        bool isRamping(int parameter) const
+        {
+            const auto index = static_cast<size_t>(parameter);
+            return start[index] != end[index];
+        }
+        
+        float getValue(int parameter, float fraction) const
+        {
+            const auto index = static_cast<size_t>(parameter);
+            return start[index] + (end[index] - start[index]) * fraction;
+        }
+        
+        std::array<float, numAutomatedParameters> start {};
+        std::array<float, numAutomatedParameters> end {};
+    };
+    
+    // Stages 1-6 for a contiguous group of channels. Lanes share nothing,
+    // so different lanes may be processed on different threads.
+    struct Lane
+    {
+        void prepare(const juce::dsp::ProcessSpec& spec, double gainRampSeconds)
+        {
+            inputGain.prepare(spec);
+            preFilters.prepare(spec);
+            saturationProcessor.prepare(spec);
+            adaptiveEqualizer.prepare(spec);
+            postFilters.prepare(spec);
+            outputGain.prepare(spec);
+            
+            // Gains ramp linearly over one automation step, so consecutive steps join up
+            inputGain.setRampDurationSeconds(gainRampSeconds);
+            outputGain.setRampDurationSeconds(gainRampSeconds);
+        }
+        
+        // Sets the continuous parameters to where the ramp is at fraction (0-1) of the host
+        // block. Only the ones that move are touched, unless all is set.
+        void applyAutomation(const AutomationRamp& ramp, float fraction, bool all = false)
+        {
+            auto apply = [&ramp, fraction, all](int parameter, auto&& setter)
+            {
+                if (all || ramp.isRamping(parameter))
+                    setter(ramp.getValue(parameter, fraction));
+            };
+            
+            apply(inputGainDb, [this](float value) { inputGain.setGainDecibels(value); });
+            apply(outputGainDb, [this](float value) { outputGain.setGainDecibels(value); });
+            
+            apply(drive, [this](float value) { saturationProcessor.setDrive(value); });
+            apply(mix, [this](float value) { saturationProcessor.setMix(value); });
+            apply(sideDrive, [this](float value) { saturationProcessor.setSideDrive(value); });
+            
+            for (int crossover = 0; crossover < maxBands - 1; ++crossover)
+                apply(firstCrossoverFrequency + crossover, [this, crossover](float value) { saturationProcessor.setCrossoverFrequency(crossover, value); });
+            
+            for (int band = 0; band < maxBands; ++band)
+            {
+                apply(firstBandDrive + band, [this, band](float value) { saturationProcessor.setBandDrive(band, value); });
+                apply(firstBandMix + band, [this, band](float value) { saturationProcessor.setBandMix(band, value); });
+            }
+            
+            // The FIR sections redesign and crossfade their kernels at their own, coarser rate
+            apply(lowCutFrequency, [this](float value) { preFilters.setLowCutFrequency(value); });
+            apply(highCutFrequency, [this](float value) { postFilters.setHighCutFrequency(value); });
+        }
+        
+        void reset()
+        {
+            inputGain.reset();
+            preFilters.reset();
+            saturationProcessor.reset();
+            adaptiveEqualizer.reset();
+            postFilters.reset();
+            outputGain.reset();
+        }
+        
+        void process(juce::dsp::AudioBlock<SampleType>& block)
+        {
+            juce::dsp::ProcessContextReplacing<SampleType> context(block);
+            stageTimer.start();
+            
+            // 1. Input gain
+            inputGain.process(context);
+            stageTimer.lap(StageProfile::inputGain);
+            
+            // 2. Pre-filtering (anti-aliasing)
+            preFilters.process(context);
+            stageTimer.lap(StageProfile::preFilters);
+            
+            // 3. Saturation processing
+            saturationProcessor.process(context);
+            stageTimer.lap(StageProfile::saturation);
+            
+            // 4. Adaptive EQ (post-saturation)
+            adaptiveEqualizer.process(context);
+            stageTimer.lap(StageProfile::equalizer);
+            
+            // 5. Post-filtering
+            postFilters.process(context);
+            stageTimer.lap(StageProfile::postFilters);
+            
+            // 6. Output gain
+            outputGain.process(context);
+            stageTimer.lap(StageProfile::outputGain);
+        }
+        
+        // Stages run in series, so their latencies and tails add up
+        double getLatencySamples() const
+        {
+            return preFilters.getLatencySamples() + saturationProcessor.getLatencySamples() + postFilters.getLatencySamples();
+        }
+        
+        int getTailLengthSamples() const
+        {
+            return preFilters.getTailLengthSamples() + saturationProcessor.getTailLengthSamples()
+                 + adaptiveEqualizer.getTailLengthSamples() + postFilters.getTailLengthSamples();
+        }
+        
+        size_t firstChannel = 0;
+        size_t numChannels = 0;
+        
+        juce::dsp::Gain<SampleType> inputGain;
+        LinearPhaseFilters<SampleType> preFilters { LinearPhaseFilters<SampleType>::lowCut };
+        SaturationProcessor<SampleType> saturationProcessor;
+        AdaptiveEqualizer<SampleType> adaptiveEqualizer;
+        LinearPhaseFilters<SampleType> postFilters { LinearPhaseFilters<SampleType>::highCut };
+        juce::dsp::Gain<SampleType> outputGain;
+        
+        // Written only by the thread that processes this lane
+        StageTimer stageTimer;
+    };
+    
+    ProcessingChain()
+    {
+        // Always keep one lane so the editor can query it before prepare()
+        lanes.push_back(std::make_unique<Lane>());
+    }
+    
+    // channelsPerLane == 0 keeps every channel in a single lane
+    void prepare(const juce::dsp::ProcessSpec& spec, double gainRampSeconds, size_t channelsPerLane = 0)
+    {
+        const size_t totalChannels = spec.numChannels;
+        const size_t laneWidth = channelsPerLane > 0 ? channelsPerLane : juce::jmax(totalChannels, size_t(1));
+        
+        lanes.clear();
+        
+        for (size_t first = 0; first < juce::jmax(totalChannels, size_t(1)); first += laneWidth)
+        {
+            auto lane = std::make_unique<Lane>();
+            lane->firstChannel = first;
+            lane->numChannels = juce::jmin(laneWidth, totalChannels - first);
+            lane->prepare({ spec.sampleRate, spec.maximumBlockSize, static_cast<juce::uint32>(lane->numChannels) }, gainRampSeconds);
+            lanes.push_back(std::move(lane));
+        }
+        
+        loudnessCompensator.prepare(spec);
+        bypass.prepare(spec);
+        inputMeter.prepare(spec);
+        outputMeter.prepare(spec);
+        stageProfiler.prepare(spec.sampleRate);
+    }
+    
+    void reset()
+    {
+        for (auto& lane : lanes)
+            lane->reset();
+        
+        loudnessCompensator.reset();
+        bypass.reset();
+        inputMeter.reset();
+        outputMeter.reset();
+        stageProfiler.reset();
+    }
+    
+    // Stages 1-6 of the chain for one lane over a whole host block; metering and loudness
+    // compensation run per host block. While the automation ramps, the lane steps through
+    // it in sub-blocks of stepSize samples (0: one step per block). Sub-blocks are views
+    // into the host buffer, no samples are copied.
+    void processLane(size_t laneIndex, juce::dsp::AudioBlock<SampleType>& block, size_t stepSize = 0)
+    {
+        auto& lane = *lanes[laneIndex];
+        
+        if (lane.firstChannel >= block.getNumChannels())
+        {
+            if (automation.isRamping())
+                lane.applyAutomation(automation, 1.0f);
+            
+            return;
+        }
+        
+        auto laneBlock = block.getSubsetChannelBlock(lane.firstChannel,
+                                                     juce::jmin(lane.numChannels, block.getNumChannels() - lane.firstChannel));
+        
+        const auto numSamples = laneBlock.getNumSamples();
+        
+        if (!automation.isRamping())
+        {
+            lane.process(laneBlock);
+            return;
+        }
+        
+        const auto step = stepSize > 0 ? stepSize : numSamples;
+        
+        for (size_t offset = 0; offset < numSamples; offset += step)
+        {
+            const auto length = juce::jmin(step, numSamples - offset);
+            lane.applyAutomation(automation, static_cast<float>(offset + length) / static_cast<float>(numSamples));
+            
+            auto subBlock = laneBlock.getSubBlock(offset, length);
+            lane.process(subBlock);
+        }
+    }
+    
+    void process(juce::dsp::AudioBlock<SampleType>& block, size_t stepSize = 0)
+    {
+        for (size_t laneIndex = 0; laneIndex < lanes.size(); ++laneIndex)
+            processLane(laneIndex, block, stepSize);
+    }
+    
+    // Moves every lane straight to the ramp's targets, for blocks that are not processed
+    // and after prepare(), when no module has been given any value yet
+    void finishAutomation()
+    {
+        automation.jumpToEnd();
+        
+        for (auto& lane : lanes)
+            lane->applyAutomation(automation, 1.0f, true);
+    }
+    
+    size_t getNumLanes() const { return lanes.size(); }
+    
+    int getLatencySamples() const
+    {
+        double latency = 0.0;
+        
+        for (auto& lane : lanes)
+            latency = juce::jmax(latency, lane->getLatencySamples());
+        
+        return juce::roundToInt(latency);
+    }
+    
+    int getTailLengthSamples() const
+    {
+        int tail = 0;
+        
+        for (auto& lane : lanes)
+            tail = juce::jmax(tail, lane->getTailLengthSamples());
+        
+        return tail;
+    }
+    
+    // Lane 0 stands in for the whole chain in the editor's curve and spectrum views
+    const Lane& getPrimaryLane() const { return *lanes.front(); }
+    
+    float getSaturationRMS(size_t channel) const
+    {
+        for (auto& lane : lanes)
+            if (channel >= lane->firstChannel && channel < lane->firstChannel + lane->numChannels)
+                return lane->saturationProcessor.getRMSLevel(static_cast<int>(channel - lane->firstChannel));
+        return 0.0f;
+    }
+    
+    float getSaturationPeak(size_t channel) const
+    {
+        for (auto& lane : lanes)
+            if (channel >= lane->firstChannel && channel < lane->firstChannel + lane->numChannels)
+                return lane->saturationProcessor.getPeakLevel(static_cast<int>(channel - lane->firstChannel));
+        return 0.0f;
+    }
+    
+    // Heap memory of the prepared chain; lanes of one module are reported together
+    void addMemoryUsage(MemoryFootprint& footprint) const
+    {
+        for (auto& lane : lanes)
+        {
+            footprint.add("Lanes", sizeof(Lane));
+            footprint.add("Saturation + oversampling", lane->saturationProcessor.getMemoryUsage());
+            footprint.add("FIR filters", lane->preFilters.getMemoryUsage() + lane->postFilters.getMemoryUsage());
+            footprint.add("Adaptive EQ + FFT", lane->adaptiveEqualizer.getMemoryUsage());
+        }
+        
+        footprint.add("Loudness compensation", loudnessCompensator.getMemoryUsage());
+        footprint.add("Level meters", inputMeter.getMemoryUsage() + outputMeter.getMemoryUsage());
+        footprint.add("Bypass delay", bypass.getMemoryUsage());
+    }
+    
+    std::vector<std::unique_ptr<Lane>> lanes;
+    AutomationRamp automation;
+    LoudnessCompensator<SampleType> loudnessCompensator;
+    LatencyCompensatedBypass<SampleType> bypass;
+    
+    // Fused input/output metering (one pass per buffer each)
+    LevelMeter<SampleType> inputMeter;
+    LevelMeter<SampleType> outputMeter;
+    
+    // Per-stage CPU load; the chain timer covers the per-block metering and compensation
+    StageTimer chainTimer;
+    StageProfiler stageProfiler;
+};
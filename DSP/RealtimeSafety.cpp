@@ -0,0 +1,337 @@
+#include "RealtimeSafety.h"
+
+#if PSAT_REALTIME_SAFETY_CHECKS
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <malloc.h>
+ #include <pthread.h>
+
+// glibc's own entry points, so the wrappers below can forward without recursing
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+#elif JUCE_MAC
+ #include <malloc/malloc.h>
+#elif JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+namespace RealtimeSafety
+{
+    namespace
+    {
+        // Constant-initialised, so reading them is safe even while a thread starts up
+        thread_local int audioThreadDepth = 0;
+        thread_local int permitDepth = 0;
+        
+        std::atomic<int> numViolations { 0 };
+        
+        // Later violations are only counted, so a bad loop cannot flood the log
+        constexpr int maxReportedViolations = 32;
+        
+        // Heap accounting for ScopedAllocationCounter; off unless one is alive
+        std::atomic<bool> countingAllocations { false };
+        std::atomic<juce::int64> countedBytes { 0 };
+        
+        size_t getAllocationSize(void* pointer) noexcept
+        {
+           #if JUCE_LINUX
+            return malloc_usable_size(pointer);
+           #elif JUCE_MAC
+            return malloc_size(pointer);
+           #elif JUCE_WINDOWS
+            return _msize(pointer);
+           #else
+            return 0;
+           #endif
+        }
+        
+        void countAllocation(void* pointer) noexcept
+        {
+            if (pointer != nullptr && countingAllocations.load(std::memory_order_relaxed))
+                countedBytes.fetch_add(static_cast<juce::int64>(getAllocationSize(pointer)), std::memory_order_relaxed);
+        }
+        
+        void countDeallocation(void* pointer) noexcept
+        {
+            if (pointer != nullptr && countingAllocations.load(std::memory_order_relaxed))
+                countedBytes.fetch_sub(static_cast<juce::int64>(getAllocationSize(pointer)), std::memory_order_relaxed);
+        }
+        
+        bool isChecking() noexcept
+        {
+            return audioThreadDepth > 0 && permitDepth == 0;
+        }
+        
+        void reportViolation(const char* what) noexcept
+        {
+            // Reporting allocates and locks itself
+            ++permitDepth;
+            
+            const auto index = numViolations.fetch_add(1);
+            
+            if (index < maxReportedViolations)
+            {
+                const auto trace = juce::SystemStats::getStackBacktrace();
+                std::fprintf(stderr, "Real-time safety violation: %s on the audio thread\n%s\n", what, trace.toRawUTF8());
+            }
+            
+            --permitDepth;
+        }
+        
+        void* allocate(size_t size) noexcept
+        {
+           #if JUCE_LINUX
+            auto* pointer = __libc_malloc(size);
+           #else
+            auto* pointer = std::malloc(size);
+           #endif
+            
+            countAllocation(pointer);
+            return pointer;
+        }
+        
+        void deallocate(void* pointer) noexcept
+        {
+            countDeallocation(pointer);
+            
+           #if JUCE_LINUX
+            __libc_free(pointer);
+           #else
+            std::free(pointer);
+           #endif
+        }
+        
+        // Over-allocates and keeps the raw pointer just below the aligned one
+        void* allocateAligned(size_t size, size_t alignment) noexcept
+        {
+            auto* raw = static_cast<char*>(allocate(size + alignment + sizeof(void*)));
+            
+            if (raw == nullptr)
+                return nullptr;
+            
+            const auto address = reinterpret_cast<uintptr_t>(raw + sizeof(void*));
+            auto* aligned = reinterpret_cast<void**>((address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+            aligned[-1] = raw;
+            return aligned;
+        }
+        
+        void deallocateAligned(void* pointer) noexcept
+        {
+            if (pointer != nullptr)
+                deallocate(static_cast<void**>(pointer)[-1]);
+        }
+        
+        void* checkedNew(size_t size)
+        {
+            if (isChecking())
+                reportViolation("operator new");
+            
+            if (auto* pointer = allocate(size == 0 ? 1 : size))
+                return pointer;
+            
+            throw std::bad_alloc();
+        }
+        
+        void* checkedAlignedNew(size_t size, std::align_val_t alignment)
+        {
+            if (isChecking())
+                reportViolation("aligned operator new");
+            
+            if (auto* pointer = allocateAligned(size == 0 ? 1 : size, static_cast<size_t>(alignment)))
+                return pointer;
+            
+            throw std::bad_alloc();
+        }
+        
+        void checkedDelete(void* pointer) noexcept
+        {
+            if (pointer != nullptr && isChecking())
+                reportViolation("operator delete");
+            
+            deallocate(pointer);
+        }
+        
+        void checkedAlignedDelete(void* pointer) noexcept
+        {
+            if (pointer != nullptr && isChecking())
+                reportViolation("aligned operator delete");
+            
+            deallocateAligned(pointer);
+        }
+       
+       #if JUCE_LINUX
+        // Resolved lazily without a function-local static, whose guard may itself lock
+        template <typename Function>
+        Function findNext(std::atomic<Function>& cache, const char* name) noexcept
+        {
+            auto function = cache.load(std::memory_order_relaxed);
+            
+            if (function == nullptr)
+            {
+                function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+                cache.store(function, std::memory_order_relaxed);
+            }
+            
+            return function;
+        }
+        
+        std::atomic<int (*)(pthread_mutex_t*)> nextMutexLock { nullptr };
+        std::atomic<int (*)(pthread_rwlock_t*)> nextReadLock { nullptr };
+        std::atomic<int (*)(pthread_rwlock_t*)> nextWriteLock { nullptr };
+       #endif
+    }
+    
+    ScopedAudioThread::ScopedAudioThread() noexcept   { ++audioThreadDepth; }
+    ScopedAudioThread::~ScopedAudioThread() noexcept  { --audioThreadDepth; }
+    
+    ScopedPermit::ScopedPermit() noexcept   { ++permitDepth; }
+    ScopedPermit::~ScopedPermit() noexcept  { --permitDepth; }
+    
+    int getNumViolations() noexcept
+    {
+        return numViolations.load();
+    }
+    
+    void resetViolations() noexcept
+    {
+        numViolations.store(0);
+    }
+    
+    ScopedAllocationCounter::ScopedAllocationCounter() noexcept
+    {
+        jassert(! countingAllocations.load());
+        startBytes = countedBytes.load();
+        countingAllocations.store(true);
+    }
+    
+    ScopedAllocationCounter::~ScopedAllocationCounter() noexcept
+    {
+        countingAllocations.store(false);
+    }
+    
+    juce::int64 ScopedAllocationCounter::getNetBytes() const noexcept
+    {
+        return countedBytes.load() - startBytes;
+    }
+}
+
+// Replacements for every global allocation function
+void* operator new(size_t size)                                            { return RealtimeSafety::checkedNew(size); }
+void* operator new[](size_t size)                                          { return RealtimeSafety::checkedNew(size); }
+void* operator new(size_t size, std::align_val_t alignment)                { return RealtimeSafety::checkedAlignedNew(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment)              { return RealtimeSafety::checkedAlignedNew(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try { return RealtimeSafety::checkedNew(size); } catch (...) { return nullptr; }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    try { return RealtimeSafety::checkedNew(size); } catch (...) { return nullptr; }
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return RealtimeSafety::checkedAlignedNew(size, alignment); } catch (...) { return nullptr; }
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return RealtimeSafety::checkedAlignedNew(size, alignment); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* pointer) noexcept                                                    { RealtimeSafety::checkedDelete(pointer); }
+void operator delete[](void* pointer) noexcept                                                  { RealtimeSafety::checkedDelete(pointer); }
+void operator delete(void* pointer, size_t) noexcept                                            { RealtimeSafety::checkedDelete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept                                          { RealtimeSafety::checkedDelete(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept                             { RealtimeSafety::checkedDelete(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept                           { RealtimeSafety::checkedDelete(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept                                  { RealtimeSafety::checkedAlignedDelete(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept                                { RealtimeSafety::checkedAlignedDelete(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept                          { RealtimeSafety::checkedAlignedDelete(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept                        { RealtimeSafety::checkedAlignedDelete(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept           { RealtimeSafety::checkedAlignedDelete(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept         { RealtimeSafety::checkedAlignedDelete(pointer); }
+
+#if JUCE_LINUX
+// C allocation (juce::HeapBlock, std::malloc) and blocking locks (juce::CriticalSection,
+// std::mutex, WaitableEvent) all end up here. Try-locks stay allowed.
+extern "C"
+{
+    void* malloc(size_t size)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::reportViolation("malloc");
+        
+        auto* pointer = __libc_malloc(size);
+        RealtimeSafety::countAllocation(pointer);
+        return pointer;
+    }
+    
+    void* calloc(size_t count, size_t size)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::reportViolation("calloc");
+        
+        auto* pointer = __libc_calloc(count, size);
+        RealtimeSafety::countAllocation(pointer);
+        return pointer;
+    }
+    
+    void* realloc(void* pointer, size_t size)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::reportViolation("realloc");
+        
+        RealtimeSafety::countDeallocation(pointer);
+        auto* reallocated = __libc_realloc(pointer, size);
+        
+        // A failed realloc leaves the old block in place
+        RealtimeSafety::countAllocation(reallocated != nullptr || size == 0 ? reallocated : pointer);
+        return reallocated;
+    }
+    
+    void free(void* pointer)
+    {
+        if (pointer != nullptr && RealtimeSafety::isChecking())
+            RealtimeSafety::reportViolation("free");
+        
+        RealtimeSafety::countDeallocation(pointer);
+        __libc_free(pointer);
+    }
+    
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::reportViolation("pthread_mutex_lock");
+        
+        return RealtimeSafety::findNext(RealtimeSafety::nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+    
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::reportViolation("pthread_rwlock_rdlock");
+        
+        return RealtimeSafety::findNext(RealtimeSafety::nextReadLock, "pthread_rwlock_rdlock")(lock);
+    }
+    
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::reportViolation("pthread_rwlock_wrlock");
+        
+        return RealtimeSafety::findNext(RealtimeSafety::nextWriteLock, "pthread_rwlock_wrlock")(lock);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Debug/test aid for the audio path. Builds with PSAT_REALTIME_SAFETY_CHECKS=1
+// replace the global allocation functions (and, on Linux, malloc and blocking
+// pthread locks) with versions that report every call made while a
+// ScopedAudioThread is alive on the calling thread, with a stack trace.
+// The same hooks measure heap use for Tools/MemoryFootprintCheck.
+// Interception is only reliable when these sources are linked into the
+// executable itself, as in Tools/RealtimeSafetyCheck. Normal builds compile
+// the guards to nothing.
+#ifndef PSAT_REALTIME_SAFETY_CHECKS
+ #define PSAT_REALTIME_SAFETY_CHECKS 0
+#endif
+
+namespace RealtimeSafety
+{
+#if PSAT_REALTIME_SAFETY_CHECKS
+    // Marks the calling thread as running audio code for its lifetime; nestable
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+    
+    // Exempts a deliberate, bounded exception (e.g. signalling a parked worker)
+    class ScopedPermit
+    {
+    public:
+        ScopedPermit() noexcept;
+        ~ScopedPermit() noexcept;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedPermit)
+    };
+    
+    // Violations seen by all threads since the last reset
+    int getNumViolations() noexcept;
+    void resetViolations() noexcept;
+    
+    // Heap bytes allocated minus bytes freed, on any thread, while it is alive; sizes
+    // are the allocator's usable sizes, i.e. what the heap really hands out. Frees of
+    // older allocations count negative. Not nestable.
+    class ScopedAllocationCounter
+    {
+    public:
+        ScopedAllocationCounter() noexcept;
+        ~ScopedAllocationCounter() noexcept;
+        
+        juce::int64 getNetBytes() const noexcept;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllocationCounter)
+    
+    private:
+        juce::int64 startBytes = 0;
+    };
+#else
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept {}
+    };
+    
+    struct ScopedPermit
+    {
+        ScopedPermit() noexcept {}
+    };
+    
+    inline int getNumViolations() noexcept { return 0; }
+    inline void resetViolations() noexcept {}
+#endif
+}
@@ -1,117 +1,426 @@
 #include "SaturationProcessor.h"
+#include "MemoryFootprint.h"
 
-SaturationProcessor::SaturationProcessor() 
-    : oversampler(2, oversamplingFactor, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, false)
+template <typename SampleType>
+SaturationProcessor<SampleType>::SaturationProcessor()
 {
-    rmsLevels.resize(2, 0.0f);
-    peakLevels.resize(2, 0.0f);
-    hysteresisState.resize(2, 0.0f);
-    temperatureDrift.resize(2, 0.0f);
-    biasState.resize(2, 0.0f);
 }
 
-void SaturationProcessor::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void SaturationProcessor<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
 {
     dryWetMixer.prepare(spec);
-    oversampler.initProcessing(spec.maximumBlockSize);
+    
+    oversampler = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+        static_cast<size_t>(spec.numChannels), static_cast<size_t>(oversamplingOrder),
+        juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR, true, false);
+    oversampler->initProcessing(spec.maximumBlockSize);
+    maximumBlockSize = spec.maximumBlockSize;
+    
+    // The crossover runs inside the oversampled domain
+    oversamplingRatio = oversampler->getOversamplingFactor();
+    crossover.prepare({ spec.sampleRate * static_cast<double>(oversamplingRatio),
+                        static_cast<juce::uint32>(spec.maximumBlockSize * oversamplingRatio),
+                        spec.numChannels });
+    
+    oversampledRate = spec.sampleRate * static_cast<double>(oversamplingRatio);
+    triodePreamp.prepare(oversampledRate);
+    hysteresis.prepare(spec.sampleRate * static_cast<double>(oversamplingRatio), static_cast<int>(spec.numChannels));
     
     rmsLevels.resize(spec.numChannels, 0.0f);
     peakLevels.resize(spec.numChannels, 0.0f);
-    hysteresisState.resize(spec.numChannels, 0.0f);
-    temperatureDrift.resize(spec.numChannels, 0.0f);
-    biasState.resize(spec.numChannels, 0.0f);
+    channelStates.resize(spec.numChannels);
+    bandStates.resize(spec.numChannels * static_cast<size_t>(maxBands));
+    
+    // Enough delayed states for any model trained at 44.1 kHz or above
+    maxNeuralDelay = juce::jmax(1, static_cast<int>(std::ceil(oversampledRate / minNeuralModelRate)));
+    neuralStates.resize((channelStates.size() + bandStates.size()) * static_cast<size_t>(maxNeuralDelay));
+    updateNeuralDelay();
     
     reset();
 }
 
-void SaturationProcessor::reset()
+template <typename SampleType>
+void SaturationProcessor<SampleType>::reset()
 {
     dryWetMixer.reset();
-    oversampler.reset();
+    
+    if (oversampler != nullptr)
+        oversampler->reset();
+    
+    currentDriveGain = juce::Decibels::decibelsToGain(static_cast<SampleType>(drive));
+    currentSideDriveGain = juce::Decibels::decibelsToGain(static_cast<SampleType>(sideDrive));
     
     std::fill(rmsLevels.begin(), rmsLevels.end(), 0.0f);
     std::fill(peakLevels.begin(), peakLevels.end(), 0.0f);
-    std::fill(hysteresisState.begin(), hysteresisState.end(), 0.0f);
-    std::fill(temperatureDrift.begin(), temperatureDrift.end(), 0.0f);
-    std::fill(biasState.begin(), biasState.end(), 0.0f);
+    std::fill(channelStates.begin(), channelStates.end(), makeChannelState());
+    std::fill(bandStates.begin(), bandStates.end(), makeChannelState());
+    assignNeuralStates();
+    
+    crossover.reset();
+    hysteresis.reset();
+    
+    for (auto& band : bandSettings)
+        band.currentDriveGain = juce::Decibels::decibelsToGain(static_cast<SampleType>(band.drive));
 }
 
-void SaturationProcessor::setDrive(float driveDb)
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setDrive(float driveDb)
 {
     drive = driveDb;
 }
 
-void SaturationProcessor::setMix(float mixPercent)
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setMix(float mixPercent)
 {
     mix = mixPercent / 100.0f;
-    dryWetMixer.setWetMixProportion(mix);
+    dryWetMixer.setWetMixProportion(static_cast<SampleType>(mix));
 }
 
-void SaturationProcessor::setSaturationType(int type)
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setSaturationType(int type)
 {
-    saturationType = juce::jlimit(0, 4, type);
+    saturationType = juce::jlimit(0, neuralModelType, type);
 }
 
-void SaturationProcessor::setSoloMode(bool solo)
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setSoloMode(bool solo)
 {
     soloMode = solo;
 }
 
-float SaturationProcessor::getRMSLevel(int channel) const
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setNeuralModel(const NeuralAmpModel<SampleType>* model)
+{
+    if (model == neuralModel.load())
+        return;
+    
+    neuralModel.store(model);
+    updateNeuralDelay();
+    
+    // Recurrent state from a different network is meaningless
+    assignNeuralStates();
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::updateNeuralDelay()
+{
+    const auto* model = neuralModel.load();
+    neuralDelay = model != nullptr ? juce::jlimit(1, maxNeuralDelay, juce::roundToInt(oversampledRate / model->getSampleRate())) : 1;
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::assignNeuralStates()
+{
+    std::fill(neuralStates.begin(), neuralStates.end(), NeuralModelState<SampleType>());
+    
+    if (neuralStates.empty())
+        return;
+    
+    auto* next = neuralStates.data();
+    
+    for (auto* states : { &channelStates, &bandStates })
+    {
+        for (auto& state : *states)
+        {
+            state.neural = next;
+            state.neuralPhase = 0;
+            next += maxNeuralDelay;
+        }
+    }
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setOversamplingOrder(int order)
+{
+    oversamplingOrder = juce::jlimit(0, 4, order);
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setTubeModel(int model)
+{
+    tubeModel = juce::jlimit(static_cast<int>(TubeClassic), static_cast<int>(TubeWDF), model);
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setTapeModel(int model)
+{
+    model = juce::jlimit(static_cast<int>(TapeClassic), static_cast<int>(TapeHysteresisRK4), model);
+    
+    if (model != TapeClassic)
+        hysteresis.setSolver(model == TapeHysteresisRK2 ? JilesAthertonHysteresis<SampleType>::RK2
+                                                        : JilesAthertonHysteresis<SampleType>::RK4);
+    
+    // Start the solver from rest rather than from stale memory
+    if (model != tapeModel)
+        hysteresis.reset();
+    
+    tapeModel = model;
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setStereoMode(int mode)
+{
+    stereoMode = juce::jlimit(static_cast<int>(LeftRight), static_cast<int>(MidSide), mode);
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setSideDrive(float driveDb)
+{
+    sideDrive = driveDb;
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setSideSaturationType(int type)
+{
+    sideSaturationType = juce::jlimit(0, neuralModelType, type);
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setNumBands(int bands)
+{
+    numBands = juce::jlimit(1, maxBands, bands);
+    crossover.setNumBands(numBands);
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setCrossoverFrequency(int index, float frequency)
+{
+    crossover.setCrossoverFrequency(index, frequency);
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setBandDrive(int band, float driveDb)
+{
+    if (band >= 0 && band < maxBands)
+        bandSettings[static_cast<size_t>(band)].drive = driveDb;
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setBandSaturationType(int band, int type)
+{
+    if (band >= 0 && band < maxBands)
+        bandSettings[static_cast<size_t>(band)].type = juce::jlimit(0, neuralModelType, type);
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::setBandMix(int band, float mixPercent)
+{
+    if (band >= 0 && band < maxBands)
+        bandSettings[static_cast<size_t>(band)].mix = static_cast<SampleType>(juce::jlimit(0.0f, 100.0f, mixPercent) / 100.0f);
+}
+
+template <typename SampleType>
+float SaturationProcessor<SampleType>::getRMSLevel(int channel) const
 {
     if (channel >= 0 && static_cast<size_t>(channel) < rmsLevels.size())
         return rmsLevels[static_cast<size_t>(channel)];
     return 0.0f;
 }
 
-float SaturationProcessor::getPeakLevel(int channel) const
+template <typename SampleType>
+float SaturationProcessor<SampleType>::getPeakLevel(int channel) const
 {
     if (channel >= 0 && static_cast<size_t>(channel) < peakLevels.size())
         return peakLevels[static_cast<size_t>(channel)];
     return 0.0f;
 }
 
-float SaturationProcessor::getSaturationCurveValue(float input) const
+template <typename SampleType>
+int SaturationProcessor<SampleType>::getTailLengthSamples() const
+{
+    if (oversampler == nullptr)
+        return 0;
+    
+    const auto sampleRate = oversampledRate / static_cast<double>(oversampler->getOversamplingFactor());
+    const auto tailSeconds = tubeModel == TubeWDF ? triodeTailSeconds : stateTailSeconds;
+    
+    return static_cast<int>(std::ceil(static_cast<double>(oversampler->getLatencyInSamples()) + tailSeconds * sampleRate));
+}
+
+template <typename SampleType>
+double SaturationProcessor<SampleType>::getLatencySamples() const
 {
-    float driven = input * juce::Decibels::decibelsToGain(drive);
+    return oversampler != nullptr ? static_cast<double>(oversampler->getLatencyInSamples()) : 0.0;
+}
+
+template <typename SampleType>
+float SaturationProcessor<SampleType>::getSaturationCurveValue(float input) const
+{
+    SampleType driven = static_cast<SampleType>(input) * juce::Decibels::decibelsToGain(static_cast<SampleType>(drive));
     
-    switch (saturationType)
+    // Evaluate from a fresh state so drawing the curve never disturbs the audio channels
+    auto scratch = makeChannelState();
+    return static_cast<float>(saturate(driven, saturationType, scratch));
+}
+
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::saturate(SampleType input, int type, ChannelState& state) const
+{
+    switch (type)
     {
-        case 0: return tubeWarmSaturation(driven);
-        case 1: return tapeClassicSaturation(driven);
-        case 2: return transistorModernSaturation(driven);
-        case 3: return diodeHarshSaturation(driven);
-        case 4: return vintageFuzzSaturation(driven);
-        default: return driven;
+        case 0: return tubeModel == TubeWDF ? wdfTriodeSaturation(input, state) : tubeWarmSaturation(input, state);
+        case 1: return tapeClassicSaturation(input, state);
+        case 2: return transistorModernSaturation(input, state);
+        case 3: return diodeHarshSaturation(input);
+        case 4: return vintageFuzzSaturation(input, state);
+        case neuralModelType: return neuralSaturation(input, state);
+        default: return input;
+    }
+}
+
+template <typename SampleType>
+typename SaturationProcessor<SampleType>::ChannelState SaturationProcessor<SampleType>::makeChannelState() const
+{
+    ChannelState state;
+    state.triode = triodePreamp.getRestState();
+    return state;
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::processMultiband(juce::dsp::AudioBlock<SampleType>& block, bool midSide)
+{
+    const auto numSamples = block.getNumSamples();
+    const auto bandCount = static_cast<size_t>(numBands);
+    
+    // Per-band drive ramps across the block, as in the single-band path
+    std::array<SampleType, maxBands> targetGains {};
+    std::array<SampleType, maxBands> gainSteps {};
+    
+    for (size_t band = 0; band < bandCount; ++band)
+    {
+        auto& settings = bandSettings[band];
+        targetGains[band] = juce::Decibels::decibelsToGain(static_cast<SampleType>(settings.drive));
+        gainSteps[band] = numSamples > 0
+            ? (targetGains[band] - settings.currentDriveGain) / static_cast<SampleType>(numSamples) : SampleType(0);
+    }
+    
+    // In M/S mode every band of the side signal shares the side drive and type
+    const auto targetSideGain = juce::Decibels::decibelsToGain(static_cast<SampleType>(sideDrive));
+    const auto sideGainStep = numSamples > 0
+        ? (targetSideGain - currentSideDriveGain) / static_cast<SampleType>(numSamples) : SampleType(0);
+    
+    typename LinkwitzRileyCrossover<SampleType>::Bands bands {};
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* channelData = block.getChannelPointer(channel);
+        auto* states = bandStates.data() + channel * static_cast<size_t>(maxBands);
+        const bool isSide = midSide && channel == 1;
+        
+        std::array<SampleType, maxBands> driveGains {};
+        std::array<SampleType, maxBands> driveSteps {};
+        std::array<int, maxBands> types {};
+        std::array<SampleType, maxBands> mixes {};
+        
+        for (size_t band = 0; band < bandCount; ++band)
+        {
+            const auto& settings = bandSettings[band];
+            driveGains[band] = isSide ? currentSideDriveGain : settings.currentDriveGain;
+            driveSteps[band] = isSide ? sideGainStep : gainSteps[band];
+            types[band] = isSide ? sideSaturationType : settings.type;
+            mixes[band] = soloMode ? SampleType(1) : settings.mix;
+        }
+        
+        SampleType rms = 0;
+        SampleType peak = 0;
+        
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            const SampleType input = channelData[sample];
+            crossover.processSample(static_cast<int>(channel), input, bands);
+            
+            SampleType sum = 0;
+            
+            for (size_t band = 0; band < bandCount; ++band)
+            {
+                driveGains[band] += driveSteps[band];
+                
+                const SampleType saturated = saturate(bands[band] * driveGains[band], types[band], states[band]);
+                sum += bands[band] + mixes[band] * (saturated - bands[band]);
+            }
+            
+            channelData[sample] = sum;
+            
+            // Calculate levels at original sample rate
+            if (sample % oversamplingRatio == 0)
+            {
+                rms += input * input;
+                peak = juce::jmax(peak, std::abs(input));
+            }
+        }
+        
+        const auto levelRMS = static_cast<float>(std::sqrt(rms / static_cast<SampleType>(numSamples / oversamplingRatio)));
+        const auto levelPeak = static_cast<float>(peak);
+        rmsLevels[channel] = rmsLevels[channel] * (1.0f - smoothingTime) + levelRMS * smoothingTime;
+        peakLevels[channel] = peakLevels[channel] * (1.0f - smoothingTime) + levelPeak * smoothingTime;
+    }
+    
+    for (size_t band = 0; band < bandCount; ++band)
+        bandSettings[band].currentDriveGain = targetGains[band];
+    
+    if (midSide)
+        currentSideDriveGain = targetSideGain;
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::encodeMidSide(juce::dsp::AudioBlock<SampleType>& block)
+{
+    auto* left = block.getChannelPointer(0);
+    auto* right = block.getChannelPointer(1);
+    
+    for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
+    {
+        const auto mid = (left[sample] + right[sample]) * SampleType(0.5);
+        const auto side = (left[sample] - right[sample]) * SampleType(0.5);
+        left[sample] = mid;
+        right[sample] = side;
+    }
+}
+
+template <typename SampleType>
+void SaturationProcessor<SampleType>::decodeMidSide(juce::dsp::AudioBlock<SampleType>& block)
+{
+    auto* mid = block.getChannelPointer(0);
+    auto* side = block.getChannelPointer(1);
+    
+    for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
+    {
+        const auto left = mid[sample] + side[sample];
+        const auto right = mid[sample] - side[sample];
+        mid[sample] = left;
+        side[sample] = right;
     }
 }
 
 // Tube Warm - Multi-stage triode modeling
-float SaturationProcessor::tubeWarmSaturation(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::tubeWarmSaturation(SampleType input, ChannelState& state) const
 {
     // Three-stage triode cascade
-    float stage1 = triodeStage(input, -0.7f, 20.0f);
-    float stage2 = triodeStage(stage1, -1.2f, 15.0f);
-    float stage3 = triodeStage(stage2, -0.9f, 10.0f);
+    SampleType stage1 = triodeStage(input, -0.7f, 20.0f);
+    SampleType stage2 = triodeStage(stage1, -1.2f, 15.0f);
+    SampleType stage3 = triodeStage(stage2, -0.9f, 10.0f);
     
     // Output transformer saturation
-    float transformed = outputTransformer(stage3);
+    SampleType transformed = outputTransformer(stage3, state.transformerLastOutput);
     
-    return juce::jlimit(-0.95f, 0.95f, transformed);
+    return juce::jlimit(SampleType(-0.95), SampleType(0.95), transformed);
 }
 
-float SaturationProcessor::triodeStage(float input, float bias, float gain) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::triodeStage(SampleType input, SampleType bias, SampleType gain) const
 {
     // Asymmetric transfer function characteristic of triodes
-    float biased = input + bias * 0.1f;
-    float amplified = biased * gain;
+    SampleType biased = input + bias * 0.1f;
+    SampleType amplified = biased * gain;
     
     // Triode plate current equation approximation
     if (amplified < -2.0f)
         return 0.0f; // Cutoff region
     
-    float exponential = std::exp(amplified * 0.5f);
-    float output = (exponential - 1.0f) / (exponential + 1.0f);
+    SampleType exponential = std::exp(amplified * 0.5f);
+    SampleType output = (exponential - 1.0f) / (exponential + 1.0f);
     
     // Add even harmonics characteristic
     output += 0.05f * output * output;
@@ -119,88 +428,124 @@ float SaturationProcessor::triodeStage(float input, float bias, float gain) cons
     return output * 0.7f;
 }
 
-float SaturationProcessor::outputTransformer(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::outputTransformer(SampleType input, SampleType& lastOutput) const
 {
     // Transformer core saturation
-    float normalized = input * 2.0f;
-    float saturated = normalized / (1.0f + std::abs(normalized) * 0.3f);
+    SampleType normalized = input * 2.0f;
+    SampleType saturated = normalized / (1.0f + std::abs(normalized) * 0.3f);
     
     // Hysteresis effect
-    static float lastOutput = 0.0f;
-    float hysteresis = 0.05f * (saturated - lastOutput);
+    SampleType hysteresis = 0.05f * (saturated - lastOutput);
     lastOutput = saturated;
     
     return (saturated + hysteresis) * 0.8f;
 }
 
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::wdfTriodeSaturation(SampleType input, ChannelState& state) const
+{
+    // Coupling caps and cathode bypass make the drive frequency dependent
+    const auto output = triodePreamp.processSample(input, state.triode);
+    
+    return juce::jlimit(SampleType(-0.95), SampleType(0.95), output);
+}
+
+// Neural Model - recurrent network capture of a hardware unit
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::neuralSaturation(SampleType input, ChannelState& state) const
+{
+    const auto* model = neuralModel.load(std::memory_order_acquire);
+    
+    // Nothing loaded yet: the stage stays clean
+    if (model == nullptr)
+        return input;
+    
+    // Scratch channels (curve display) start from silence
+    if (state.neural == nullptr)
+    {
+        NeuralModelState<SampleType> scratch;
+        return juce::jlimit(SampleType(-0.95), SampleType(0.95), model->processSample(input, scratch));
+    }
+    
+    auto& delayedState = state.neural[state.neuralPhase];
+    state.neuralPhase = state.neuralPhase + 1 < neuralDelay ? state.neuralPhase + 1 : 0;
+    
+    return juce::jlimit(SampleType(-0.95), SampleType(0.95), model->processSample(input, delayedState));
+}
+
 // Tape Classic - Advanced magnetic tape modeling
-float SaturationProcessor::tapeClassicSaturation(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::tapeClassicSaturation(SampleType input, ChannelState& state) const
 {
     // Magnetic hysteresis with bias
-    float biased = biasSimulation(input);
-    float hysteretic = magneticHysteresis(biased, hysteresisState[0]);
-    float processed = headGapModeling(hysteretic);
+    SampleType biased = biasSimulation(input, state.biasPhase);
+    SampleType hysteretic = magneticHysteresis(biased, state.hysteresis);
+    SampleType processed = headGapModeling(hysteretic, state.headGapLastInput);
     
-    return juce::jlimit(-0.9f, 0.9f, processed);
+    return juce::jlimit(SampleType(-0.9), SampleType(0.9), processed);
 }
 
-float SaturationProcessor::magneticHysteresis(float input, float& state) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::magneticHysteresis(SampleType input, SampleType& state) const
 {
     // Simplified magnetic hysteresis model
-    float coercivity = 0.3f;
-    float saturation = 0.8f;
+    SampleType coercivity = 0.3f;
+    SampleType saturation = 0.8f;
     
     if (std::abs(input) > coercivity)
     {
-        float direction = input > 0.0f ? 1.0f : -1.0f;
+        SampleType direction = input > 0.0f ? 1.0f : -1.0f;
         state = direction * saturation * std::tanh(std::abs(input) / coercivity);
     }
     
     // Magnetic lag
-    float output = 0.7f * input + 0.3f * state;
+    SampleType output = 0.7f * input + 0.3f * state;
     return output;
 }
 
-float SaturationProcessor::biasSimulation(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::biasSimulation(SampleType input, SampleType& biasPhase) const
 {
     // AC bias adds high-frequency content for linearization
-    static float biasPhase = 0.0f;
     biasPhase += 0.1f; // High frequency bias
     
-    float bias = 0.05f * std::sin(biasPhase);
+    SampleType bias = 0.05f * std::sin(biasPhase);
     return input + bias;
 }
 
-float SaturationProcessor::headGapModeling(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::headGapModeling(SampleType input, SampleType& lastInput) const
 {
     // Gap loss affects high frequencies
-    static float lastInput = 0.0f;
-    float derivative = input - lastInput;
+    SampleType derivative = input - lastInput;
     lastInput = input;
     
     // Frequency-dependent loss
-    float loss = 0.1f * derivative;
+    SampleType loss = 0.1f * derivative;
     return input - loss;
 }
 
 // Transistor Modern - Class-AB modeling
-float SaturationProcessor::transistorModernSaturation(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::transistorModernSaturation(SampleType input, ChannelState& state) const
 {
-    float crossover = classABCrossover(input);
-    float feedback = negativeFeedback(crossover, 0.05f);
+    SampleType crossover = classABCrossover(input);
+    SampleType feedback = negativeFeedback(crossover, 0.05f, state.feedbackDelayedOutput);
     
-    return juce::jlimit(-0.95f, 0.95f, feedback);
+    return juce::jlimit(SampleType(-0.95), SampleType(0.95), feedback);
 }
 
-float SaturationProcessor::classABCrossover(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::classABCrossover(SampleType input) const
 {
     // Class-AB crossover distortion
-    float threshold = 0.02f;
+    SampleType threshold = 0.02f;
     
     if (std::abs(input) < threshold)
     {
         // Crossover region - both transistors partially off
-        float distortion = 0.3f * input * input * input;
+        SampleType distortion = 0.3f * input * input * input;
         return input + distortion;
     }
     
@@ -208,39 +553,40 @@ float SaturationProcessor::classABCrossover(float input) const
     return input * 0.98f;
 }
 
-float SaturationProcessor::negativeFeedback(float input, float feedback) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::negativeFeedback(SampleType input, SampleType feedback, SampleType& delayedOutput) const
 {
     // Negative feedback reduces distortion and extends bandwidth
-    static float delayedOutput = 0.0f;
-    
-    float corrected = input - feedback * delayedOutput;
+    SampleType corrected = input - feedback * delayedOutput;
     delayedOutput = corrected;
     
     return corrected;
 }
 
 // Diode Harsh - Shockley equation modeling
-float SaturationProcessor::diodeHarshSaturation(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::diodeHarshSaturation(SampleType input) const
 {
-    float clipped = shockleyDiode(input, true); // Silicon
-    float opamp = opAmpSaturation(clipped);
+    SampleType clipped = shockleyDiode(input, true); // Silicon
+    SampleType opamp = opAmpSaturation(clipped);
     
-    return juce::jlimit(-0.98f, 0.98f, opamp);
+    return juce::jlimit(SampleType(-0.98), SampleType(0.98), opamp);
 }
 
-float SaturationProcessor::shockleyDiode(float input, bool silicon) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::shockleyDiode(SampleType input, bool silicon) const
 {
     // Shockley diode equation: I = Is * (exp(V/nVt) - 1)
-    float thermalVoltage = silicon ? 0.026f : 0.033f; // Vt at room temperature
-    float ideality = silicon ? 1.0f : 1.3f; // n factor
+    SampleType thermalVoltage = silicon ? 0.026f : 0.033f; // Vt at room temperature
+    SampleType ideality = silicon ? 1.0f : 1.3f; // n factor
     
-    float normalized = input / thermalVoltage / ideality;
+    SampleType normalized = input / thermalVoltage / ideality;
     
     if (normalized > 10.0f) // Prevent numerical overflow
         normalized = 10.0f;
     
-    float exponential = std::exp(normalized);
-    float current = (exponential - 1.0f) / exponential;
+    SampleType exponential = std::exp(normalized);
+    SampleType current = (exponential - 1.0f) / exponential;
     
     // Asymmetric clipping for silicon vs germanium
     if (input > 0.0f)
@@ -249,68 +595,90 @@ float SaturationProcessor::shockleyDiode(float input, bool silicon) const
         return -current * (silicon ? 0.7f : 0.2f);
 }
 
-float SaturationProcessor::opAmpSaturation(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::opAmpSaturation(SampleType input) const
 {
     // Op-amp rail saturation
-    float supply = 12.0f; // ±12V supply
-    float normalizedInput = input * supply;
+    SampleType supply = 12.0f; // ±12V supply
+    SampleType normalizedInput = input * supply;
     
     // Smooth saturation near rails
-    float saturated = std::tanh(normalizedInput / supply) * 0.9f;
+    SampleType saturated = std::tanh(normalizedInput / supply) * 0.9f;
     
     return saturated;
 }
 
 // Vintage Fuzz - Germanium transistor modeling
-float SaturationProcessor::vintageFuzzSaturation(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::vintageFuzzSaturation(SampleType input, ChannelState& state) const
 {
     // Temperature-dependent germanium behavior
-    float temperature = 25.0f + temperatureDrift[0] * 10.0f; // Room temp + drift
-    float processed = germaniumTransistor(input, temperature);
-    float fuzzed = intermodulationDistortion(processed);
+    SampleType temperature = 25.0f + state.temperatureDrift * 10.0f; // Room temp + drift
+    SampleType processed = germaniumTransistor(input, temperature, state.temperatureDrift);
+    SampleType fuzzed = intermodulationDistortion(processed, state);
     
-    return juce::jlimit(-0.85f, 0.85f, fuzzed);
+    return juce::jlimit(SampleType(-0.85), SampleType(0.85), fuzzed);
 }
 
-float SaturationProcessor::germaniumTransistor(float input, float temperature) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::germaniumTransistor(SampleType input, SampleType temperature, SampleType& temperatureDrift) const
 {
     // Germanium transistor characteristics with temperature dependency
-    float thermalVoltage = 0.026f * (temperature + 273.15f) / 298.15f;
-    float leakageCurrent = 0.01f * std::exp((temperature - 25.0f) / 10.0f);
+    SampleType thermalVoltage = 0.026f * (temperature + 273.15f) / 298.15f;
+    SampleType leakageCurrent = 0.01f * std::exp((temperature - 25.0f) / 10.0f);
     
     // Base-collector leakage affects biasing
-    float biasShift = leakageCurrent * 0.1f;
-    float biased = input + biasShift;
+    SampleType biasShift = leakageCurrent * 0.1f;
+    SampleType biased = input + biasShift;
     
     // Exponential collector current
-    float normalized = biased / thermalVoltage;
+    SampleType normalized = biased / thermalVoltage;
     if (normalized > 10.0f) normalized = 10.0f;
     
-    float current = std::tanh(normalized);
+    SampleType current = std::tanh(normalized);
     
     // Temperature instability
-    temperatureDrift[0] += (input * input - temperatureDrift[0]) * 0.001f;
+    temperatureDrift += (input * input - temperatureDrift) * 0.001f;
     
     return current * 0.8f;
 }
 
-float SaturationProcessor::intermodulationDistortion(float input) const
+template <typename SampleType>
+SampleType SaturationProcessor<SampleType>::intermodulationDistortion(SampleType input, ChannelState& state) const
 {
     // Intermodulation between cascaded stages
-    static float stage1Memory = 0.0f;
-    static float stage2Memory = 0.0f;
-    
     // First stage
-    float stage1 = std::tanh(input * 3.0f) * 0.7f;
+    SampleType stage1 = std::tanh(input * 3.0f) * 0.7f;
     
     // Intermodulation with previous sample
-    float intermod = 0.05f * stage1 * stage1Memory;
-    stage1Memory = stage1;
+    SampleType intermod = 0.05f * stage1 * state.fuzzStage1Memory;
+    state.fuzzStage1Memory = stage1;
     
     // Second stage with memory
-    float stage2 = std::tanh((stage1 + intermod) * 2.0f) * 0.8f;
-    float finalIntermod = 0.03f * stage2 * stage2Memory;
-    stage2Memory = stage2;
+    SampleType stage2 = std::tanh((stage1 + intermod) * 2.0f) * 0.8f;
+    SampleType finalIntermod = 0.03f * stage2 * state.fuzzStage2Memory;
+    state.fuzzStage2Memory = stage2;
     
     return stage2 + finalIntermod;
 }
+
+template <typename SampleType>
+size_t SaturationProcessor<SampleType>::getMemoryUsage() const
+{
+    const auto numChannels = channelStates.size();
+    
+    // Each oversampling stage doubles the rate and keeps a buffer at its output rate:
+    // 2 + 4 + ... + 2^order block lengths per channel
+    const auto oversamplingBytes = oversampler != nullptr
+        ? numChannels * maximumBlockSize * (2 * oversampler->getOversamplingFactor() - 2) * sizeof(SampleType) : 0;
+    
+    // The dry/wet mixer holds one block of dry signal
+    const auto mixerBytes = numChannels * maximumBlockSize * sizeof(SampleType);
+    
+    return oversamplingBytes + mixerBytes + hysteresis.getMemoryUsage()
+         + MemoryFootprint::bytesOf(neuralStates) + MemoryFootprint::bytesOf(rmsLevels) + MemoryFootprint::bytesOf(peakLevels)
+         + MemoryFootprint::bytesOf(channelStates) + MemoryFootprint::bytesOf(bandStates);
+}
+
+template class SaturationProcessor<float>;
+template class SaturationProcessor<double>;
@@ -1,10 +1,37 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "LinkwitzRileyCrossover.h"
+#include "JilesAthertonHysteresis.h"
+#include "WDFTriodePreamp.h"
+#include "NeuralAmpModel.h"
 
+template <typename SampleType>
 class SaturationProcessor
 {
 public:
+    enum StereoMode
+    {
+        LeftRight,
+        MidSide
+    };
+    
+    enum TubeModel
+    {
+        TubeClassic,
+        TubeWDF
+    };
+    
+    enum TapeModel
+    {
+        TapeClassic,
+        TapeHysteresisRK2,
+        TapeHysteresisRK4
+    };
+
+    // Saturation type index of the loaded neural model (after the five analogue types)
+    static constexpr int neuralModelType = 5;
+    
     SaturationProcessor();
     ~SaturationProcessor() = default;
 
@@ -16,125 +43,296 @@ public:
     void setSaturationType(int type);
     void setSoloMode(bool solo);
     
+    // Model used by the neural type; nullptr leaves that type clean. The model is
+    // owned by the caller and must outlive its use here. Call between blocks on
+    // the audio thread, or before processing starts.
+    void setNeuralModel(const NeuralAmpModel<SampleType>* model);
+    
+    // Oversampling by 2^order (0-4, default 16x); takes effect at the next prepare()
+    static constexpr int defaultOversamplingOrder = 4;
+    void setOversamplingOrder(int order);
+    
+    // Selects the classic tube cascade or the wave digital filter triode preamp
+    void setTubeModel(int model);
+    
+    // Selects the per-sample tape curve or the Jiles-Atherton hysteresis solver
+    void setTapeModel(int model);
+    
+    // Mid/side mode: the main drive and type apply to mid, these to side (stereo only)
+    void setStereoMode(int mode);
+    void setSideDrive(float driveDb);
+    void setSideSaturationType(int type);
+    
+    // Multiband mode (2-4 bands): per-band drive, type and mix replace the main ones, and the
+    // main mix is not applied on top. In M/S mode the bands of the mid signal use these
+    // settings, those of the side signal the side drive and type with the band mixes.
+    // Solo plays the bands fully wet.
+    static constexpr int maxBands = LinkwitzRileyCrossover<SampleType>::maxBands;
+    void setNumBands(int bands);
+    void setCrossoverFrequency(int index, float frequency);
+    void setBandDrive(int band, float driveDb);
+    void setBandSaturationType(int band, int type);
+    void setBandMix(int band, float mixPercent);
+    
     template<typename ProcessContext>
     void process(const ProcessContext& context);
     
     float getRMSLevel(int channel) const;
     float getPeakLevel(int channel) const;
     float getSaturationCurveValue(float input) const;
+    
+    // Samples until the output falls silent after the input does: oversampling
+    // latency plus the memory of the current models. Models that can hold a value
+    // indefinitely (tape remanence, a neural model's bias) are not bounded here.
+    int getTailLengthSamples() const;
+    
+    // Delay of the oversampling filters at the host rate
+    double getLatencySamples() const;
+    
+    // Heap memory allocated by prepare(), in bytes (see MemoryFootprint)
+    size_t getMemoryUsage() const;
 
 private:
+    // Memory carried between samples by the analogue models, one per channel
+    struct ChannelState
+    {
+        SampleType transformerLastOutput = 0;
+        SampleType hysteresis = 0;
+        SampleType biasPhase = 0;
+        SampleType headGapLastInput = 0;
+        SampleType feedbackDelayedOutput = 0;
+        SampleType temperatureDrift = 0;
+        SampleType fuzzStage1Memory = 0;
+        SampleType fuzzStage2Memory = 0;
+        typename WDFTriodePreamp<SampleType>::State triode {};
+        NeuralModelState<SampleType>* neural = nullptr; // neuralDelay consecutive states, see neuralStates
+        int neuralPhase = 0;
+    };
+    
+    // A fresh channel, with the triode circuit at its operating point
+    ChannelState makeChannelState() const;
+    
+    SampleType saturate(SampleType input, int type, ChannelState& state) const;
+    
+    // Split, saturate and re-sum the bands of the oversampled block in place
+    void processMultiband(juce::dsp::AudioBlock<SampleType>& block, bool midSide);
+    
+    // In-place M/S matrix on the oversampled block (exact inverse of each other)
+    static void encodeMidSide(juce::dsp::AudioBlock<SampleType>& block);
+    static void decodeMidSide(juce::dsp::AudioBlock<SampleType>& block);
+    
     // Tube Warm - Multi-stage triode modeling
-    float tubeWarmSaturation(float input) const;
-    float triodeStage(float input, float bias, float gain) const;
-    float outputTransformer(float input) const;
+    SampleType tubeWarmSaturation(SampleType input, ChannelState& state) const;
+    SampleType triodeStage(SampleType input, SampleType bias, SampleType gain) const;
+    SampleType outputTransformer(SampleType input, SampleType& lastOutput) const;
+    SampleType wdfTriodeSaturation(SampleType input, ChannelState& state) const;
+    
+    // Neural Model - recurrent network capture of a hardware unit
+    SampleType neuralSaturation(SampleType input, ChannelState& state) const;
+    void assignNeuralStates();
+    void updateNeuralDelay();
     
     // Tape Classic - Advanced magnetic tape modeling
-    float tapeClassicSaturation(float input) const;
-    float magneticHysteresis(float input, float& state) const;
-    float biasSimulation(float input) const;
-    float headGapModeling(float input) const;
+    SampleType tapeClassicSaturation(SampleType input, ChannelState& state) const;
+    SampleType magneticHysteresis(SampleType input, SampleType& state) const;
+    SampleType biasSimulation(SampleType input, SampleType& biasPhase) const;
+    SampleType headGapModeling(SampleType input, SampleType& lastInput) const;
     
     // Transistor Modern - Class-AB modeling
-    float transistorModernSaturation(float input) const;
-    float classABCrossover(float input) const;
-    float negativeFeedback(float input, float feedback) const;
+    SampleType transistorModernSaturation(SampleType input, ChannelState& state) const;
+    SampleType classABCrossover(SampleType input) const;
+    SampleType negativeFeedback(SampleType input, SampleType feedback, SampleType& delayedOutput) const;
     
     // Diode Harsh - Shockley equation modeling
-    float diodeHarshSaturation(float input) const;
-    float shockleyDiode(float input, bool silicon = true) const;
-    float opAmpSaturation(float input) const;
+    SampleType diodeHarshSaturation(SampleType input) const;
+    SampleType shockleyDiode(SampleType input, bool silicon = true) const;
+    SampleType opAmpSaturation(SampleType input) const;
     
     // Vintage Fuzz - Germanium transistor modeling
-    float vintageFuzzSaturation(float input) const;
-    float germaniumTransistor(float input, float temperature) const;
-    float intermodulationDistortion(float input) const;
+    SampleType vintageFuzzSaturation(SampleType input, ChannelState& state) const;
+    SampleType germaniumTransistor(SampleType input, SampleType temperature, SampleType& temperatureDrift) const;
+    SampleType intermodulationDistortion(SampleType input, ChannelState& state) const;
     
-    juce::dsp::DryWetMixer<float> dryWetMixer;
+    juce::dsp::DryWetMixer<SampleType> dryWetMixer;
     
     float drive = 0.0f;
+    SampleType currentDriveGain = 1; // ramps towards drive across each processed block
     float mix = 1.0f;
     int saturationType = 0;
     bool soloMode = false;
+    int tubeModel = TubeClassic;
+    int tapeModel = TapeClassic;
+    
+    int stereoMode = LeftRight;
+    float sideDrive = 0.0f;
+    SampleType currentSideDriveGain = 1;
+    int sideSaturationType = 0;
+    
+    struct BandSettings
+    {
+        float drive = 0.0f;
+        SampleType currentDriveGain = 1;
+        int type = 0;
+        SampleType mix = 1;
+    };
+    
+    int numBands = 1;
+    std::array<BandSettings, maxBands> bandSettings;
+    LinkwitzRileyCrossover<SampleType> crossover;
+    
+    // Circuit constants of the WDF tube model, adapted to the oversampled rate
+    WDFTriodePreamp<SampleType> triodePreamp;
+    
+    // The neural model runs at the oversampled rate. A model trained at rate fs is
+    // run at k * fs by feeding each sample the recurrent state from k samples
+    // earlier, which keeps its time constants; every channel (and band) owns
+    // maxNeuralDelay states for this.
+    std::atomic<const NeuralAmpModel<SampleType>*> neuralModel { nullptr };
+    std::vector<NeuralModelState<SampleType>> neuralStates;
+    int neuralDelay = 1;
+    int maxNeuralDelay = 1;
+    double oversampledRate = 44100.0;
+    static constexpr double minNeuralModelRate = 44100.0;
+    
+    // Block-based tape model; runs in the oversampled domain (single-band only)
+    JilesAthertonHysteresis<SampleType> hysteresis;
     
     std::vector<float> rmsLevels;
     std::vector<float> peakLevels;
     
-    // Saturation algorithm states
-    mutable std::vector<float> hysteresisState;
-    mutable std::vector<float> temperatureDrift;
-    mutable std::vector<float> biasState;
+    // Saturation algorithm states, sized from the prepared channel count
+    std::vector<ChannelState> channelStates;
+    std::vector<ChannelState> bandStates; // maxBands per channel
     
     static constexpr float smoothingTime = 0.02f;
-    static constexpr int oversamplingFactor = 4;
     
-    juce::dsp::Oversampling<float> oversampler;
+    // Decay of the oversampling filters, crossovers and short sample memories,
+    // and of the WDF coupling and cathode capacitors
+    static constexpr double stateTailSeconds = 0.05;
+    static constexpr double triodeTailSeconds = 0.4;
+    
+    // Oversampling configuration; the ratio also decimates the level meters
+    int oversamplingOrder = defaultOversamplingOrder;
+    size_t oversamplingRatio = size_t(1) << defaultOversamplingOrder;
+    
+    // Built in prepare() once the channel count is known
+    std::unique_ptr<juce::dsp::Oversampling<SampleType>> oversampler;
+    size_t maximumBlockSize = 0;
 };
 
-template<typename ProcessContext>
-void SaturationProcessor::process(const ProcessContext& context)
+template <typename SampleType>
+template <typename ProcessContext>
+void SaturationProcessor<SampleType>::process(const ProcessContext& context)
 {
     auto& inputBlock = context.getInputBlock();
     auto& outputBlock = context.getOutputBlock();
     
     jassert(inputBlock.getNumChannels() == outputBlock.getNumChannels());
     jassert(inputBlock.getNumSamples() == outputBlock.getNumSamples());
+    jassert(inputBlock.getNumChannels() <= channelStates.size());
     
     juce::ignoreUnused(inputBlock.getNumChannels(), inputBlock.getNumSamples());
     
-    // Store dry signal for mix (unless in solo mode)
+    // Oversample for high-quality saturation
+    auto oversampledBlock = oversampler->processSamplesUp(inputBlock);
+    
+    // M/S is encoded in place after upsampling, so both components share one oversampler
+    const bool midSide = stereoMode == MidSide && oversampledBlock.getNumChannels() == 2;
+    
+    if (midSide)
+        encodeMidSide(oversampledBlock);
+    
+    // Bands are split after upsampling and summed before downsampling: one oversampler for all
+    // of them. Each band mixes its own dry signal, so the main dry/wet mixer stays out.
+    if (numBands > 1)
+    {
+        processMultiband(oversampledBlock, midSide);
+        
+        if (midSide)
+            decodeMidSide(oversampledBlock);
+        
+        oversampler->processSamplesDown(outputBlock);
+        return;
+    }
+    
+    // Store dry signal for mix (unless in solo mode); upsampling has left the input untouched
     if (!soloMode)
         dryWetMixer.pushDrySamples(inputBlock);
     
-    // Oversample for high-quality saturation
-    auto oversampledBlock = oversampler.processSamplesUp(inputBlock);
+    // Ramp the drive gain linearly across the block so automation does not step
+    const auto oversampledSamples = oversampledBlock.getNumSamples();
+    const auto targetDriveGain = juce::Decibels::decibelsToGain(static_cast<SampleType>(drive));
+    const auto targetSideDriveGain = juce::Decibels::decibelsToGain(static_cast<SampleType>(sideDrive));
+    
+    // The hysteresis model solves whole channels at once instead of sample by sample
+    const bool hysteresisModel = tapeModel != TapeClassic;
     
     // Apply saturation with oversampling
     for (size_t channel = 0; channel < oversampledBlock.getNumChannels(); ++channel)
     {
         auto* channelData = oversampledBlock.getChannelPointer(channel);
-        const auto oversampledSamples = oversampledBlock.getNumSamples();
+        auto& state = channelStates[channel];
+        
+        // In M/S mode channel 1 carries the side signal
+        const bool isSide = midSide && channel == 1;
+        const int type = isSide ? sideSaturationType : saturationType;
+        const auto startGain = isSide ? currentSideDriveGain : currentDriveGain;
+        const auto endGain = isSide ? targetSideDriveGain : targetDriveGain;
+        const auto driveGainStep = oversampledSamples > 0
+            ? (endGain - startGain) / static_cast<SampleType>(oversampledSamples) : SampleType(0);
+        
+        const bool blockSolved = hysteresisModel && type == 1;
         
-        float rms = 0.0f;
-        float peak = 0.0f;
+        SampleType rms = 0;
+        SampleType peak = 0;
+        SampleType driveGain = startGain;
         
         for (size_t sample = 0; sample < oversampledSamples; ++sample)
         {
-            float input = channelData[sample];
-            float driven = input * juce::Decibels::decibelsToGain(drive);
-            float saturated = 0.0f;
-            
-            switch (saturationType)
-            {
-                case 0: saturated = tubeWarmSaturation(driven); break;
-                case 1: saturated = tapeClassicSaturation(driven); break;
-                case 2: saturated = transistorModernSaturation(driven); break;
-                case 3: saturated = diodeHarshSaturation(driven); break;
-                case 4: saturated = vintageFuzzSaturation(driven); break;
-                default: saturated = driven; break;
-            }
+            SampleType input = channelData[sample];
+            driveGain += driveGainStep;
             
-            channelData[sample] = saturated;
+            if (!blockSolved)
+                channelData[sample] = saturate(input * driveGain, type, state);
             
             // Calculate levels at original sample rate
-            if (sample % oversamplingFactor == 0)
+            if (sample % oversamplingRatio == 0)
             {
                 rms += input * input;
                 peak = juce::jmax(peak, std::abs(input));
             }
         }
         
-        // Update level meters
-        rms = std::sqrt(rms / (oversampledSamples / oversamplingFactor));
-        if (channel < rmsLevels.size())
+        // Mid and side carry different drives, so each is solved on its own
+        if (blockSolved && midSide)
         {
-            rmsLevels[channel] = rmsLevels[channel] * (1.0f - smoothingTime) + rms * smoothingTime;
-            peakLevels[channel] = peakLevels[channel] * (1.0f - smoothingTime) + peak * smoothingTime;
+            auto channelBlock = oversampledBlock.getSubsetChannelBlock(channel, 1);
+            hysteresis.process(channelBlock, startGain, driveGainStep, channel);
         }
+        
+        // Update level meters (mid and side levels in M/S mode)
+        const auto levelRMS = static_cast<float>(std::sqrt(rms / static_cast<SampleType>(oversampledSamples / oversamplingRatio)));
+        const auto levelPeak = static_cast<float>(peak);
+        rmsLevels[channel] = rmsLevels[channel] * (1.0f - smoothingTime) + levelRMS * smoothingTime;
+        peakLevels[channel] = peakLevels[channel] * (1.0f - smoothingTime) + levelPeak * smoothingTime;
+    }
+    
+    // Otherwise all channels share one drive ramp and are stepped together
+    if (hysteresisModel && !midSide && saturationType == 1)
+    {
+        const auto driveGainStep = oversampledSamples > 0
+            ? (targetDriveGain - currentDriveGain) / static_cast<SampleType>(oversampledSamples) : SampleType(0);
+        hysteresis.process(oversampledBlock, currentDriveGain, driveGainStep);
     }
     
+    if (midSide)
+        decodeMidSide(oversampledBlock);
+    
+    currentDriveGain = targetDriveGain;
+    currentSideDriveGain = targetSideDriveGain;
+    
     // Downsample back to original rate
-    oversampler.processSamplesDown(outputBlock);
+    oversampler->processSamplesDown(outputBlock);
     
     // Apply dry/wet mix (unless in solo mode)
     if (!soloMode)
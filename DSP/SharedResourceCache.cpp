@@ -0,0 +1,54 @@
+#include "SharedResourceCache.h"
+
+namespace
+{
+    // The cache only observes: ownership stays with the instances using a resource
+    struct Store
+    {
+        juce::CriticalSection lock;
+        std::map<juce::String, std::weak_ptr<const void>> entries;
+    };
+    
+    Store& getStore()
+    {
+        static Store store;
+        return store;
+    }
+}
+
+std::shared_ptr<const void> SharedResourceCache::find(const juce::String& key)
+{
+    auto& store = getStore();
+    const juce::ScopedLock lock(store.lock);
+    
+    const auto entry = store.entries.find(key);
+    return entry != store.entries.end() ? entry->second.lock() : nullptr;
+}
+
+std::shared_ptr<const void> SharedResourceCache::insert(const juce::String& key, std::shared_ptr<const void> resource)
+{
+    auto& store = getStore();
+    const juce::ScopedLock lock(store.lock);
+    
+    auto& entry = store.entries[key];
+    
+    if (auto existing = entry.lock())
+        return existing;
+    
+    entry = resource;
+    
+    // Drop entries whose last user has gone, so the map does not grow with every configuration seen
+    for (auto it = store.entries.begin(); it != store.entries.end();)
+        it = it->second.expired() ? store.entries.erase(it) : std::next(it);
+    
+    return resource;
+}
+
+int SharedResourceCache::getNumResources()
+{
+    auto& store = getStore();
+    const juce::ScopedLock lock(store.lock);
+    
+    return static_cast<int>(std::count_if(store.entries.begin(), store.entries.end(),
+                                          [](const auto& entry) { return !entry.second.expired(); }));
+}
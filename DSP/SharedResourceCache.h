@@ -0,0 +1,35 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <typeinfo>
+
+// Process-wide store for read-only tables that are identical across plugin instances
+// (window tables, lookup tables). Entries are keyed by type and a configuration string
+// and reference-counted: every instance asking for the same key shares one copy, which
+// is freed with its last user. Thread-safe, but it locks and allocates, so resources are
+// fetched when preparing, never on the audio thread. Only share objects whose use is
+// truly lock-free: juce::dsp::FFT, for one, locks inside perform() with some engines.
+class SharedResourceCache
+{
+public:
+    // create() returns a std::shared_ptr or std::unique_ptr to a new Resource. It runs
+    // outside the lock; if two threads race, both get the one stored first.
+    template <typename Resource, typename Factory>
+    static std::shared_ptr<const Resource> get(const juce::String& key, Factory&& create)
+    {
+        const auto fullKey = key + " | " + typeid(Resource).name();
+        
+        if (auto existing = find(fullKey))
+            return std::static_pointer_cast<const Resource>(existing);
+        
+        std::shared_ptr<const Resource> created = create();
+        return std::static_pointer_cast<const Resource>(insert(fullKey, std::move(created)));
+    }
+    
+    // Number of distinct resources currently alive
+    static int getNumResources();
+
+private:
+    static std::shared_ptr<const void> find(const juce::String& key);
+    static std::shared_ptr<const void> insert(const juce::String& key, std::shared_ptr<const void> resource);
+};
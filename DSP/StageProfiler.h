@@ -0,0 +1,165 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <chrono>
+#include "TraceRecorder.h"
+
+// Per-stage CPU cost of the processing chain. Lanes time their own stages with a
+// StageTimer; the audio thread folds the lane totals into a StageProfiler once per
+// host block, whose rolling figures are published with the meter frame.
+namespace StageProfile
+{
+    enum Stage
+    {
+        inputGain,
+        preFilters,
+        saturation,
+        equalizer,
+        postFilters,
+        outputGain,
+        compensation,
+        numStages
+    };
+
+    inline const char* getStageName(int stage)
+    {
+        static const char* const names[] = { "Input gain", "Pre-filters", "Saturation", "Adaptive EQ",
+                                             "Post-filters", "Output gain", "Compensation" };
+        return juce::isPositiveAndBelow(stage, static_cast<int>(numStages)) ? names[stage] : "";
+    }
+
+    using Nanoseconds = std::array<juce::int64, numStages>;
+}
+
+// Accumulates the time spent in each stage, and marks the stages on the trace timeline
+// while a trace is recording. Only touched by the thread that runs the owning lane;
+// when neither is active, start() and lap() are a single branch.
+class StageTimer
+{
+public:
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+    bool isEnabled() const noexcept { return enabled; }
+
+    void start() noexcept
+    {
+        tracing = Trace::isRecording();
+
+        if (enabled || tracing)
+            lastTime = Clock::now();
+    }
+
+    // Charges the time since the previous start() or lap() to stage
+    void lap(int stage) noexcept
+    {
+        if (enabled || tracing)
+        {
+            const auto now = Clock::now();
+            const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastTime).count();
+
+            if (enabled)
+                elapsed[static_cast<size_t>(stage)] += nanoseconds;
+
+            if (tracing)
+                Trace::complete(StageProfile::getStageName(stage),
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(lastTime.time_since_epoch()).count(), nanoseconds);
+
+            lastTime = now;
+        }
+    }
+
+    // Adds the accumulated times to totals and starts over
+    void drainInto(StageProfile::Nanoseconds& totals) noexcept
+    {
+        for (size_t stage = 0; stage < totals.size(); ++stage)
+            totals[stage] += elapsed[stage];
+
+        elapsed.fill(0);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool enabled = false;
+    bool tracing = false;
+    Clock::time_point lastTime;
+    StageProfile::Nanoseconds elapsed {};
+};
+
+// Audio thread: turns per-block stage times into load figures, in percent of the
+// real-time budget. Averages cover a window of audio; worst cases are the most
+// expensive single block of the window.
+class StageProfiler
+{
+public:
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        windowSamples = static_cast<juce::int64>(newSampleRate * windowSeconds);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        windowNanoseconds.fill(0);
+        windowWorstLoad.fill(0.0f);
+        windowWorstTotalLoad = 0.0f;
+        windowSampleCount = 0;
+        averageLoad.fill(0.0f);
+        worstLoad.fill(0.0f);
+        worstTotalLoad = 0.0f;
+    }
+
+    void addBlock(const StageProfile::Nanoseconds& blockNanoseconds, int numSamples) noexcept
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return;
+
+        const auto blockBudget = static_cast<double>(numSamples) * 1.0e9 / sampleRate;
+        juce::int64 blockTotal = 0;
+
+        for (size_t stage = 0; stage < blockNanoseconds.size(); ++stage)
+        {
+            windowNanoseconds[stage] += blockNanoseconds[stage];
+            windowWorstLoad[stage] = juce::jmax(windowWorstLoad[stage], static_cast<float>(100.0 * blockNanoseconds[stage] / blockBudget));
+            blockTotal += blockNanoseconds[stage];
+        }
+
+        // Stage worst cases rarely coincide, so the whole block's worst case is tracked separately
+        windowWorstTotalLoad = juce::jmax(windowWorstTotalLoad, static_cast<float>(100.0 * blockTotal / blockBudget));
+
+        windowSampleCount += numSamples;
+
+        if (windowSampleCount >= windowSamples)
+        {
+            const auto windowBudget = static_cast<double>(windowSampleCount) * 1.0e9 / sampleRate;
+
+            for (size_t stage = 0; stage < averageLoad.size(); ++stage)
+                averageLoad[stage] = static_cast<float>(100.0 * windowNanoseconds[stage] / windowBudget);
+
+            worstLoad = windowWorstLoad;
+            worstTotalLoad = windowWorstTotalLoad;
+            windowNanoseconds.fill(0);
+            windowWorstLoad.fill(0.0f);
+            windowWorstTotalLoad = 0.0f;
+            windowSampleCount = 0;
+        }
+    }
+
+    // Figures of the last completed window
+    const std::array<float, StageProfile::numStages>& getAverageLoad() const noexcept { return averageLoad; }
+    const std::array<float, StageProfile::numStages>& getWorstLoad() const noexcept { return worstLoad; }
+    float getWorstTotalLoad() const noexcept { return worstTotalLoad; }
+
+private:
+    static constexpr double windowSeconds = 0.5;
+
+    double sampleRate = 0.0;
+    juce::int64 windowSamples = 0;
+    juce::int64 windowSampleCount = 0;
+    StageProfile::Nanoseconds windowNanoseconds {};
+    std::array<float, StageProfile::numStages> windowWorstLoad {};
+    float windowWorstTotalLoad = 0.0f;
+    std::array<float, StageProfile::numStages> averageLoad {};
+    std::array<float, StageProfile::numStages> worstLoad {};
+    float worstTotalLoad = 0.0f;
+};
@@ -0,0 +1,300 @@
+#include "TraceRecorder.h"
+
+#if PSAT_TRACING
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+namespace Trace
+{
+    namespace
+    {
+        struct Event
+        {
+            juce::int64 timeNanoseconds;
+            const char* name;
+            juce::int64 value; // duration for complete events
+            char phase;        // Chrome trace phase: B, E, i or X
+            char detail[23];
+        };
+        
+        // One ring per thread, single producer (its thread) and single consumer (the writer)
+        struct ThreadBuffer
+        {
+            static constexpr juce::uint64 capacity = 8192; // power of two
+            
+            std::array<Event, capacity> events;
+            std::atomic<juce::uint64> writeCount { 0 };
+            std::atomic<juce::uint64> readCount { 0 };
+            std::atomic<juce::uint64> numDropped { 0 };
+            std::atomic<bool> claimed { false };
+            char threadName[32] {};
+        };
+        
+        // Buffers are created with the first recording and never freed, since threads
+        // keep pointing at theirs for as long as they live
+        constexpr int maxThreads = 32;
+        std::array<std::unique_ptr<ThreadBuffer>, maxThreads> buffers;
+        std::atomic<int> numClaimedBuffers { 0 };
+        std::atomic<bool> recording { false };
+        
+        // Constant-initialised, so reading it is safe even while a thread starts up
+        thread_local ThreadBuffer* threadBuffer = nullptr;
+        
+        juce::int64 now() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+        
+        ThreadBuffer* claimBuffer() noexcept
+        {
+            auto index = numClaimedBuffers.load(std::memory_order_relaxed);
+            
+            do
+            {
+                if (index >= maxThreads)
+                    return nullptr;
+            }
+            while (! numClaimedBuffers.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+            
+            auto* buffer = buffers[static_cast<size_t>(index)].get();
+            
+            // Named once, without allocating: threads the plugin did not create are the host's
+            if (auto* thread = juce::Thread::getCurrentThread())
+                thread->getThreadName().copyToUTF8(buffer->threadName, sizeof(buffer->threadName));
+            else if (auto* messageManager = juce::MessageManager::getInstanceWithoutCreating(); messageManager != nullptr && messageManager->isThisTheMessageThread())
+                std::snprintf(buffer->threadName, sizeof(buffer->threadName), "Message thread");
+            else
+                std::snprintf(buffer->threadName, sizeof(buffer->threadName), "Host thread %d", index);
+            
+            buffer->claimed.store(true, std::memory_order_release);
+            threadBuffer = buffer;
+            return buffer;
+        }
+        
+        Event* beginWrite(ThreadBuffer*& buffer) noexcept
+        {
+            if (! recording.load(std::memory_order_relaxed))
+                return nullptr;
+            
+            buffer = threadBuffer;
+            
+            if (buffer == nullptr && (buffer = claimBuffer()) == nullptr)
+                return nullptr;
+            
+            const auto index = buffer->writeCount.load(std::memory_order_relaxed);
+            
+            // The writer has fallen behind: drop rather than overwrite what it is reading
+            if (index - buffer->readCount.load(std::memory_order_acquire) >= ThreadBuffer::capacity)
+            {
+                buffer->numDropped.store(buffer->numDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            
+            return &buffer->events[index & (ThreadBuffer::capacity - 1)];
+        }
+        
+        void endWrite(ThreadBuffer* buffer) noexcept
+        {
+            buffer->writeCount.store(buffer->writeCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+        
+        void record(char phase, const char* name, juce::int64 time, juce::int64 value) noexcept
+        {
+            ThreadBuffer* buffer = nullptr;
+            
+            if (auto* event = beginWrite(buffer))
+            {
+                event->timeNanoseconds = time;
+                event->name = name;
+                event->value = value;
+                event->phase = phase;
+                event->detail[0] = 0;
+                endWrite(buffer);
+            }
+        }
+        
+        // Streams the rings to the output file while a recording runs
+        class Writer : private juce::Thread
+        {
+        public:
+            Writer(std::unique_ptr<juce::FileOutputStream> streamToUse)
+                : juce::Thread("Trace writer"), stream(std::move(streamToUse)), startTime(now())
+            {
+                *stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+                writeMetadata(0, "process_name", JucePlugin_Name);
+                startThread();
+            }
+            
+            ~Writer() override
+            {
+                stopThread(-1);
+                
+                // Everything recorded before recording was switched off
+                drain();
+                
+                for (int index = 0; index < maxThreads; ++index)
+                    if (const auto dropped = buffers[static_cast<size_t>(index)]->numDropped.exchange(0))
+                        writeEvent(index + 1, "Trace events dropped", 'i', now(), static_cast<juce::int64>(dropped), nullptr);
+                
+                *stream << "\n]}\n";
+                stream->flush();
+            }
+        
+        private:
+            void run() override
+            {
+                while (! threadShouldExit())
+                {
+                    drain();
+                    wait(drainIntervalMs);
+                }
+            }
+            
+            void drain()
+            {
+                const auto numBuffers = numClaimedBuffers.load(std::memory_order_acquire);
+                
+                for (int index = 0; index < numBuffers; ++index)
+                {
+                    auto& buffer = *buffers[static_cast<size_t>(index)];
+                    
+                    if (! buffer.claimed.load(std::memory_order_acquire))
+                        continue;
+                    
+                    if (! namedThreads[static_cast<size_t>(index)])
+                    {
+                        writeMetadata(index + 1, "thread_name", buffer.threadName);
+                        namedThreads[static_cast<size_t>(index)] = true;
+                    }
+                    
+                    const auto written = buffer.writeCount.load(std::memory_order_acquire);
+                    auto read = buffer.readCount.load(std::memory_order_relaxed);
+                    
+                    for (; read < written; ++read)
+                    {
+                        const auto& event = buffer.events[read & (ThreadBuffer::capacity - 1)];
+                        writeEvent(index + 1, event.name, event.phase, event.timeNanoseconds, event.value, event.detail);
+                    }
+                    
+                    buffer.readCount.store(read, std::memory_order_release);
+                }
+                
+                stream->flush();
+            }
+            
+            void writeEvent(int threadID, const char* name, char phase, juce::int64 time, juce::int64 value, const char* detail)
+            {
+                // Microseconds since the recording started, with nanosecond resolution
+                *stream << (firstEvent ? "" : ",\n") << "{\"name\":\"" << name << "\",\"ph\":\"" << juce::String::charToString(phase)
+                        << "\",\"ts\":" << juce::String(static_cast<double>(time - startTime) * 1.0e-3, 3)
+                        << ",\"pid\":1,\"tid\":" << threadID;
+                
+                if (phase == 'X')
+                    *stream << ",\"dur\":" << juce::String(static_cast<double>(value) * 1.0e-3, 3);
+                else if (phase == 'i')
+                    *stream << ",\"s\":\"t\",\"args\":{\"value\":" << value
+                            << (detail != nullptr && detail[0] != 0 ? ",\"detail\":\"" + juce::JSON::escapeString(detail) + "\"" : juce::String())
+                            << "}";
+                
+                *stream << "}";
+                firstEvent = false;
+            }
+            
+            void writeMetadata(int threadID, const char* kind, const juce::String& name)
+            {
+                *stream << (firstEvent ? "" : ",\n") << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadID
+                        << ",\"args\":{\"name\":\"" << juce::JSON::escapeString(name) << "\"}}";
+                firstEvent = false;
+            }
+            
+            static constexpr int drainIntervalMs = 20;
+            
+            std::unique_ptr<juce::FileOutputStream> stream;
+            const juce::int64 startTime;
+            std::array<bool, maxThreads> namedThreads {};
+            bool firstEvent = true;
+        };
+        
+        std::mutex sessionLock;
+        std::unique_ptr<Writer> writer;
+    }
+    
+    void begin(const char* name) noexcept
+    {
+        record('B', name, now(), 0);
+    }
+    
+    void end(const char* name) noexcept
+    {
+        record('E', name, now(), 0);
+    }
+    
+    void instant(const char* name, juce::int64 value) noexcept
+    {
+        record('i', name, now(), value);
+    }
+    
+    void instant(const char* name, const juce::String& detail) noexcept
+    {
+        ThreadBuffer* buffer = nullptr;
+        
+        if (auto* event = beginWrite(buffer))
+        {
+            event->timeNanoseconds = now();
+            event->name = name;
+            event->value = 0;
+            event->phase = 'i';
+            detail.copyToUTF8(event->detail, sizeof(event->detail));
+            endWrite(buffer);
+        }
+    }
+    
+    void complete(const char* name, juce::int64 startNanoseconds, juce::int64 durationNanoseconds) noexcept
+    {
+        record('X', name, startNanoseconds, durationNanoseconds);
+    }
+    
+    bool startRecording(const juce::File& file)
+    {
+        const std::lock_guard<std::mutex> lock(sessionLock);
+        
+        if (writer != nullptr)
+            return false;
+        
+        file.deleteFile();
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        
+        if (! stream->openedOk())
+            return false;
+        
+        for (auto& buffer : buffers)
+        {
+            if (buffer == nullptr)
+                buffer = std::make_unique<ThreadBuffer>();
+            
+            // Leftovers from an earlier recording belong to that file
+            buffer->readCount.store(buffer->writeCount.load(std::memory_order_acquire), std::memory_order_release);
+            buffer->numDropped.store(0);
+        }
+        
+        writer = std::make_unique<Writer>(std::move(stream));
+        recording.store(true);
+        return true;
+    }
+    
+    void stopRecording()
+    {
+        const std::lock_guard<std::mutex> lock(sessionLock);
+        recording.store(false);
+        writer.reset();
+    }
+    
+    bool isRecording() noexcept
+    {
+        return recording.load(std::memory_order_relaxed);
+    }
+}
+
+#endif
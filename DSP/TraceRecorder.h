@@ -0,0 +1,63 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Timeline capture for deep profiling sessions. Builds with PSAT_TRACING=1 record
+// timestamped events (blocks, stages, parameter changes, FFT runs, coefficient
+// swaps, UI timer ticks) into lock-free per-thread ring buffers while a recording
+// is running; a background thread streams them to a Chrome trace JSON file, which
+// chrome://tracing and ui.perfetto.dev both open. Recording an event costs a clock
+// read and a handful of stores; normal builds compile every call to nothing.
+#ifndef PSAT_TRACING
+ #define PSAT_TRACING 0
+#endif
+
+namespace Trace
+{
+#if PSAT_TRACING
+    // Names must be string literals (or otherwise outlive the recording)
+    void begin(const char* name) noexcept;
+    void end(const char* name) noexcept;
+    void instant(const char* name, juce::int64 value = 0) noexcept;
+    
+    // Copies the first few characters of detail, e.g. a parameter ID
+    void instant(const char* name, const juce::String& detail) noexcept;
+    
+    // A span measured elsewhere, in steady_clock nanoseconds
+    void complete(const char* name, juce::int64 startNanoseconds, juce::int64 durationNanoseconds) noexcept;
+    
+    // Brackets a scope with begin() and end()
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(const char* nameToUse) noexcept : name(nameToUse) { begin(name); }
+        ~ScopedEvent() noexcept { end(name); }
+    
+    private:
+        const char* name;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedEvent)
+    };
+    
+    // One recording per process. Starting fails if one is already running or the
+    // file cannot be created; stopping flushes and closes the file.
+    bool startRecording(const juce::File& file);
+    void stopRecording();
+    bool isRecording() noexcept;
+#else
+    inline void begin(const char*) noexcept {}
+    inline void end(const char*) noexcept {}
+    inline void instant(const char*, juce::int64 = 0) noexcept {}
+    inline void instant(const char*, const juce::String&) noexcept {}
+    inline void complete(const char*, juce::int64, juce::int64) noexcept {}
+    
+    struct ScopedEvent
+    {
+        explicit ScopedEvent(const char*) noexcept {}
+    };
+    
+    inline bool startRecording(const juce::File&) { return false; }
+    inline void stopRecording() {}
+    constexpr bool isRecording() noexcept { return false; }
+#endif
+}
@@ -0,0 +1,132 @@
+#include "WDFTriodePreamp.h"
+
+namespace
+{
+    // Component values of one common-cathode stage
+    struct StageCircuit
+    {
+        double sourceResistance;   // grid stopper
+        double inputCapacitance;
+        double gridResistance;
+        double cathodeResistance;
+        double cathodeCapacitance;
+        double outputCapacitance;
+        double loadResistance;
+    };
+    
+    // The first stage is partially bypassed for a tighter low end, the second fully
+    constexpr std::array<StageCircuit, 2> stageCircuits {{
+        { 68.0e3, 22.0e-9, 1.0e6, 1.5e3, 4.7e-6, 22.0e-9, 1.0e6 },
+        { 68.0e3, 22.0e-9, 1.0e6, 1.5e3, 22.0e-6, 22.0e-9, 1.0e6 }
+    }};
+    
+    // Koren 12AX7 plate current in amps
+    double korenPlateCurrent(double gridCathodeVoltage, double plateCathodeVoltage)
+    {
+        constexpr double mu = 100.0, exponent = 1.4, kg1 = 1060.0, kp = 600.0, kvb = 300.0;
+        
+        if (plateCathodeVoltage <= 0.0)
+            return 0.0;
+        
+        const auto argument = juce::jmin(50.0, kp * (1.0 / mu + gridCathodeVoltage / std::sqrt(kvb + plateCathodeVoltage * plateCathodeVoltage)));
+        const auto e1 = plateCathodeVoltage / kp * std::log1p(std::exp(argument));
+        
+        return e1 > 0.0 ? std::pow(e1, exponent) / kg1 : 0.0;
+    }
+}
+
+template <typename SampleType>
+WDFTriodePreamp<SampleType>::WDFTriodePreamp()
+{
+    buildPlateTable();
+    prepare(44100.0);
+}
+
+template <typename SampleType>
+void WDFTriodePreamp<SampleType>::buildPlateTable()
+{
+    // Plate voltage on the load line for each grid voltage, found by bisection
+    for (int entry = 0; entry < plateTableSize; ++entry)
+    {
+        const auto gridVoltage = minGridVoltage + (maxGridVoltage - minGridVoltage) * entry / (plateTableSize - 1);
+        double low = 0.0, high = supplyVoltage;
+        
+        for (int iteration = 0; iteration < 60; ++iteration)
+        {
+            const auto plateVoltage = 0.5 * (low + high);
+            
+            if (supplyVoltage - plateResistance * korenPlateCurrent(gridVoltage, plateVoltage) > plateVoltage)
+                low = plateVoltage;
+            else
+                high = plateVoltage;
+        }
+        
+        plateTable[static_cast<size_t>(entry)] = static_cast<SampleType>(0.5 * (low + high));
+    }
+}
+
+template <typename SampleType>
+void WDFTriodePreamp<SampleType>::prepare(double sampleRate)
+{
+    for (size_t stage = 0; stage < static_cast<size_t>(numStages); ++stage)
+    {
+        const auto& circuit = stageCircuits[stage];
+        auto& adaptation = adaptations[stage];
+        
+        // Bilinear capacitors: R = T / 2C
+        const auto inputCapacitorResistance = 1.0 / (2.0 * sampleRate * circuit.inputCapacitance);
+        const auto cathodeCapacitorResistance = 1.0 / (2.0 * sampleRate * circuit.cathodeCapacitance);
+        const auto outputCapacitorResistance = 1.0 / (2.0 * sampleRate * circuit.outputCapacitance);
+        
+        const auto seriesResistance = circuit.sourceResistance + inputCapacitorResistance;
+        const auto seriesConductance = 1.0 / seriesResistance;
+        const auto gridConductance = 1.0 / circuit.gridResistance;
+        const auto gridPortResistance = 1.0 / (seriesConductance + gridConductance);
+        
+        const auto cathodeConductance = 1.0 / circuit.cathodeResistance;
+        const auto cathodeCapacitorConductance = 1.0 / cathodeCapacitorResistance;
+        
+        const auto outputResistance = outputCapacitorResistance + circuit.loadResistance;
+        
+        adaptation.inputCapacitorRatio = static_cast<SampleType>(inputCapacitorResistance / seriesResistance);
+        adaptation.gridSeriesShare = static_cast<SampleType>(seriesConductance * gridPortResistance);
+        adaptation.gridPortResistance = static_cast<SampleType>(gridPortResistance);
+        adaptation.gridLogTerm = static_cast<SampleType>(std::log(gridPortResistance * gridSaturationCurrent / gridThermalVoltage));
+        adaptation.cathodeCapacitorShare = static_cast<SampleType>(cathodeCapacitorConductance / (cathodeConductance + cathodeCapacitorConductance));
+        adaptation.cathodePortResistance = static_cast<SampleType>(1.0 / (cathodeConductance + cathodeCapacitorConductance));
+        adaptation.outputCapacitorRatio = static_cast<SampleType>(outputCapacitorResistance / outputResistance);
+        adaptation.outputLoadRatio = static_cast<SampleType>(circuit.loadResistance / outputResistance);
+        
+        // Quiescent point: the cathode voltage that the resulting plate current sustains
+        double low = 0.0, high = 5.0;
+        
+        for (int iteration = 0; iteration < 60; ++iteration)
+        {
+            const auto cathodeVoltage = 0.5 * (low + high);
+            const auto plateVoltage = static_cast<double>(lookupPlateVoltage(static_cast<SampleType>(-cathodeVoltage)));
+            
+            if (circuit.cathodeResistance * (supplyVoltage - plateVoltage) / plateResistance > cathodeVoltage)
+                low = cathodeVoltage;
+            else
+                high = cathodeVoltage;
+        }
+        
+        const auto cathodeVoltage = 0.5 * (low + high);
+        adaptation.restPlateVoltage = lookupPlateVoltage(static_cast<SampleType>(-cathodeVoltage));
+        
+        auto& rest = restState[stage];
+        rest.inputCapacitor = 0;
+        rest.cathodeCapacitor = static_cast<SampleType>(cathodeVoltage);
+        rest.cathodeVoltage = static_cast<SampleType>(cathodeVoltage);
+        rest.outputCapacitor = 0;
+    }
+    
+    // Let the small grid leakage settle through the coupling caps so a reset starts silent
+    const auto settleSamples = static_cast<int>(sampleRate * 0.5);
+    
+    for (int sample = 0; sample < settleSamples; ++sample)
+        processSample(0, restState);
+}
+
+template class WDFTriodePreamp<float>;
+template class WDFTriodePreamp<double>;
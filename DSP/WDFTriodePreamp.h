@@ -0,0 +1,153 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Two-stage 12AX7 preamp built from wave digital filters. Each stage has an
+// input coupling cap with grid stopper and grid-current limiting, a Koren
+// triode on a resistive plate load, a bypassed cathode resistor and an
+// output coupling cap. Port resistances are adapted once in prepare() and the
+// plate voltage is read from a table solved offline, so each stage costs one
+// Wright omega evaluation and one table lookup per sample.
+template <typename SampleType>
+class WDFTriodePreamp
+{
+public:
+    static constexpr int numStages = 2;
+    
+    // Per-channel circuit memory
+    struct StageState
+    {
+        SampleType inputCapacitor = 0;   // waves held by the reactive elements
+        SampleType cathodeCapacitor = 0;
+        SampleType outputCapacitor = 0;
+        SampleType cathodeVoltage = 0;   // fed back to the grid one sample later
+    };
+    
+    using State = std::array<StageState, numStages>;
+    
+    WDFTriodePreamp();
+    ~WDFTriodePreamp() = default;
+    
+    void prepare(double sampleRate);
+    
+    // The circuit at its quiescent operating point; channels start from here
+    const State& getRestState() const noexcept { return restState; }
+    
+    SampleType processSample(SampleType input, State& state) const noexcept;
+
+private:
+    // Port resistances and scattering coefficients of one stage
+    struct Adaptation
+    {
+        SampleType inputCapacitorRatio = 0;  // Cin share of the source/Cin series adaptor
+        SampleType gridSeriesShare = 0;      // source branch share of the grid parallel adaptor
+        SampleType gridPortResistance = 0;
+        SampleType gridLogTerm = 0;          // log(R * Is / Vt) for the Wright omega solution
+        SampleType cathodeCapacitorShare = 0;
+        SampleType cathodePortResistance = 0;
+        SampleType outputCapacitorRatio = 0;
+        SampleType outputLoadRatio = 0;
+        SampleType restPlateVoltage = 0;     // the output network sees only the swing around it
+    };
+    
+    void buildPlateTable();
+    SampleType lookupPlateVoltage(SampleType gridCathodeVoltage) const noexcept;
+    SampleType processStage(SampleType input, StageState& state, const Adaptation& adaptation) const noexcept;
+    static SampleType wrightOmega(SampleType x) noexcept;
+    
+    // Supply, plate load and grid-cathode junction shared by both stages
+    static constexpr double supplyVoltage = 250.0;
+    static constexpr double plateResistance = 100.0e3;
+    static constexpr double gridSaturationCurrent = 1.0e-8;
+    static constexpr double gridThermalVoltage = 0.05;
+    
+    // Level mapping between the digital signal and circuit voltages
+    static constexpr double inputVolts = 0.5;
+    static constexpr double interstageGain = 0.1;
+    static constexpr double outputScale = 1.0 / 120.0;
+    
+    static constexpr int plateTableSize = 512;
+    static constexpr double minGridVoltage = -8.0;
+    static constexpr double maxGridVoltage = 2.0;
+    
+    std::array<SampleType, plateTableSize> plateTable {};
+    std::array<Adaptation, numStages> adaptations {};
+    State restState {};
+};
+
+template <typename SampleType>
+SampleType WDFTriodePreamp<SampleType>::processSample(SampleType input, State& state) const noexcept
+{
+    auto signal = processStage(input * static_cast<SampleType>(inputVolts), state[0], adaptations[0]);
+    signal = processStage(signal * static_cast<SampleType>(interstageGain), state[1], adaptations[1]);
+    
+    return signal * static_cast<SampleType>(outputScale);
+}
+
+template <typename SampleType>
+SampleType WDFTriodePreamp<SampleType>::lookupPlateVoltage(SampleType gridCathodeVoltage) const noexcept
+{
+    constexpr auto tableScale = static_cast<double>(plateTableSize - 1) / (maxGridVoltage - minGridVoltage);
+    
+    const auto position = juce::jlimit(SampleType(0), static_cast<SampleType>(plateTableSize - 1),
+                                       (gridCathodeVoltage - static_cast<SampleType>(minGridVoltage)) * static_cast<SampleType>(tableScale));
+    const auto index = juce::jmin(static_cast<int>(position), plateTableSize - 2);
+    const auto fraction = position - static_cast<SampleType>(index);
+    
+    return plateTable[static_cast<size_t>(index)] + fraction * (plateTable[static_cast<size_t>(index + 1)] - plateTable[static_cast<size_t>(index)]);
+}
+
+template <typename SampleType>
+SampleType WDFTriodePreamp<SampleType>::wrightOmega(SampleType x) noexcept
+{
+    // Piecewise cubic estimate refined by one Newton step (D'Angelo et al.)
+    SampleType y;
+    
+    if (x < SampleType(-3.341459552768620))
+        y = 0;
+    else if (x < SampleType(8))
+        y = SampleType(6.313183464296682e-1)
+          + x * (SampleType(3.631952663804445e-1) + x * (SampleType(4.775931364975583e-2) + x * SampleType(-1.314293149877800e-3)));
+    else
+        y = x - std::log(x);
+    
+    return y - (y - std::exp(x - y)) / (y + SampleType(1));
+}
+
+template <typename SampleType>
+SampleType WDFTriodePreamp<SampleType>::processStage(SampleType input, StageState& state, const Adaptation& adaptation) const noexcept
+{
+    constexpr auto saturationCurrent = static_cast<SampleType>(gridSaturationCurrent);
+    constexpr auto thermalVoltage = static_cast<SampleType>(gridThermalVoltage);
+    
+    // Grid: series(source, Cin) in parallel with the grid resistor, rooted at the
+    // grid-cathode junction. The source is inverted to match the series port orientation.
+    const SampleType sourceWave = -input;
+    const SampleType seriesUp = -(sourceWave + state.inputCapacitor);
+    const SampleType parallelUp = adaptation.gridSeriesShare * seriesUp;
+    
+    // The junction sits on top of the cathode voltage from the previous sample
+    const SampleType incident = parallelUp - state.cathodeVoltage;
+    const SampleType resistanceCurrent = adaptation.gridPortResistance * saturationCurrent;
+    const SampleType reflected = incident + SampleType(2) * resistanceCurrent
+                               - SampleType(2) * thermalVoltage * wrightOmega(adaptation.gridLogTerm + (incident + resistanceCurrent) / thermalVoltage);
+    const SampleType gridVoltage = SampleType(0.5) * (incident + reflected) + state.cathodeVoltage;
+    
+    const SampleType seriesDown = SampleType(2) * gridVoltage - seriesUp;
+    state.inputCapacitor -= adaptation.inputCapacitorRatio * (seriesDown + sourceWave + state.inputCapacitor);
+    
+    // Plate: operating point on the load line, solved offline
+    const SampleType plateVoltage = lookupPlateVoltage(gridVoltage - state.cathodeVoltage);
+    const SampleType plateCurrent = (static_cast<SampleType>(supplyVoltage) - plateVoltage) / static_cast<SampleType>(plateResistance);
+    
+    // Cathode: Rk parallel Ck, rooted at the plate current
+    state.cathodeVoltage = adaptation.cathodeCapacitorShare * state.cathodeCapacitor + adaptation.cathodePortResistance * plateCurrent;
+    state.cathodeCapacitor = SampleType(2) * state.cathodeVoltage - state.cathodeCapacitor;
+    
+    // Output: series(Cout, load) rooted at the plate; the load voltage is the stage output.
+    // Working on the swing keeps the capacitor state small enough for float precision.
+    const SampleType loopWave = SampleType(2) * (plateVoltage - adaptation.restPlateVoltage + state.outputCapacitor);
+    state.outputCapacitor -= adaptation.outputCapacitorRatio * loopWave;
+    
+    return SampleType(0.5) * adaptation.outputLoadRatio * loopWave;
+}
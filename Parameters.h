@@ -10,6 +10,21 @@ namespace ParameterIDs
     const juce::String outputGain { "outputGain" };
     const juce::String satType { "satType" };
     const juce::String soloSaturation { "soloSaturation" };
+    const juce::String tubeModel { "tubeModel" };
+    const juce::String tapeModel { "tapeModel" };
+    
+    // Mid/Side saturation
+    const juce::String stereoMode { "stereoMode" };
+    const juce::String sideDrive { "sideDrive" };
+    const juce::String sideSatType { "sideSatType" };
+    
+    // Multiband saturation
+    constexpr int maxBands = 4;
+    const juce::String numBands { "numBands" };
+    const std::array<juce::String, maxBands - 1> crossoverFreq { "crossover1Freq", "crossover2Freq", "crossover3Freq" };
+    const std::array<juce::String, maxBands> bandDrive { "band1Drive", "band2Drive", "band3Drive", "band4Drive" };
+    const std::array<juce::String, maxBands> bandSatType { "band1SatType", "band2SatType", "band3SatType", "band4SatType" };
+    const std::array<juce::String, maxBands> bandMix { "band1Mix", "band2Mix", "band3Mix", "band4Mix" };
     
     // Linear Phase Filters
     const juce::String lowCutFreq { "lowCutFreq" };
@@ -31,6 +46,18 @@ namespace ParameterDefaults
     constexpr float outputGain = 0.0f;
     constexpr int satType = 0;
     constexpr bool soloSaturation = false;
+    constexpr int tubeModel = 0; // Classic
+    constexpr int tapeModel = 0; // Classic
+    
+    constexpr int stereoMode = 0; // Stereo (L/R)
+    constexpr float sideDrive = 0.0f;
+    constexpr int sideSatType = 0;
+    
+    constexpr int numBands = 0; // Single band
+    constexpr std::array<float, 3> crossoverFreq { 120.0f, 1000.0f, 6000.0f };
+    constexpr float bandDrive = 0.0f;
+    constexpr int bandSatType = 0;
+    constexpr float bandMix = 100.0f;
     
     constexpr float lowCutFreq = 20.0f;
     constexpr float highCutFreq = 20000.0f;
@@ -81,7 +108,7 @@ public:
         layout.add(std::make_unique<juce::AudioParameterChoice>(
             ParameterIDs::satType,
             "Saturation Type",
-            juce::StringArray { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz" },
+            juce::StringArray { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz", "Neural Model" },
             ParameterDefaults::satType));
 
         layout.add(std::make_unique<juce::AudioParameterBool>(
@@ -89,6 +116,80 @@ public:
             "Solo Saturation",
             ParameterDefaults::soloSaturation));
 
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            ParameterIDs::tubeModel,
+            "Tube Model",
+            juce::StringArray { "Classic", "WDF Triode" },
+            ParameterDefaults::tubeModel));
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            ParameterIDs::tapeModel,
+            "Tape Model",
+            juce::StringArray { "Classic", "Hysteresis (RK2)", "Hysteresis (RK4)" },
+            ParameterDefaults::tapeModel));
+
+        // Mid/Side saturation
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            ParameterIDs::stereoMode,
+            "Stereo Mode",
+            juce::StringArray { "Stereo", "Mid/Side" },
+            ParameterDefaults::stereoMode));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            ParameterIDs::sideDrive,
+            "Side Drive",
+            juce::NormalisableRange<float>(0.0f, 30.0f, 0.1f),
+            ParameterDefaults::sideDrive,
+            "dB"));
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            ParameterIDs::sideSatType,
+            "Side Saturation Type",
+            juce::StringArray { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz", "Neural Model" },
+            ParameterDefaults::sideSatType));
+
+        // Multiband saturation
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            ParameterIDs::numBands,
+            "Bands",
+            juce::StringArray { "Single", "2 Bands", "3 Bands", "4 Bands" },
+            ParameterDefaults::numBands));
+
+        for (size_t crossover = 0; crossover < ParameterIDs::crossoverFreq.size(); ++crossover)
+        {
+            layout.add(std::make_unique<juce::AudioParameterFloat>(
+                ParameterIDs::crossoverFreq[crossover],
+                "Crossover " + juce::String(crossover + 1),
+                juce::NormalisableRange<float>(40.0f, 16000.0f, 1.0f, 0.3f),
+                ParameterDefaults::crossoverFreq[crossover],
+                "Hz"));
+        }
+
+        for (size_t band = 0; band < static_cast<size_t>(ParameterIDs::maxBands); ++band)
+        {
+            const auto bandName = "Band " + juce::String(band + 1);
+
+            layout.add(std::make_unique<juce::AudioParameterFloat>(
+                ParameterIDs::bandDrive[band],
+                bandName + " Drive",
+                juce::NormalisableRange<float>(0.0f, 30.0f, 0.1f),
+                ParameterDefaults::bandDrive,
+                "dB"));
+
+            layout.add(std::make_unique<juce::AudioParameterChoice>(
+                ParameterIDs::bandSatType[band],
+                bandName + " Type",
+                juce::StringArray { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz", "Neural Model" },
+                ParameterDefaults::bandSatType));
+
+            layout.add(std::make_unique<juce::AudioParameterFloat>(
+                ParameterIDs::bandMix[band],
+                bandName + " Mix",
+                juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
+                ParameterDefaults::bandMix,
+                "%"));
+        }
+
         // Linear Phase Filters
         layout.add(std::make_unique<juce::AudioParameterFloat>(
             ParameterIDs::lowCutFreq,
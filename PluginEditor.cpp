@@ -21,13 +21,18 @@ ProfessionalSaturationAudioProcessorEditor::ProfessionalSaturationAudioProcessor
 ProfessionalSaturationAudioProcessorEditor::~ProfessionalSaturationAudioProcessorEditor()
 {
     stopTimer();
+    setDiagnosticsVisible(false);
     setLookAndFeel(nullptr);
     
     saturationTypeCombo.setLookAndFeel(nullptr);
+    stereoModeCombo.setLookAndFeel(nullptr);
+    sideSaturationTypeCombo.setLookAndFeel(nullptr);
     eqTargetCombo.setLookAndFeel(nullptr);
     filterEnableButton.setLookAndFeel(nullptr);
     eqEnableButton.setLookAndFeel(nullptr);
     soloButton.setLookAndFeel(nullptr);
+    loadModelButton.setLookAndFeel(nullptr);
+    diagnosticsButton.setLookAndFeel(nullptr);
 }
 
 void ProfessionalSaturationAudioProcessorEditor::setupComponents()
@@ -67,6 +72,9 @@ void ProfessionalSaturationAudioProcessorEditor::setupComponents()
     driveKnob = std::make_unique<KnobComponent>("DRIVE", audioProcessor.getValueTreeState(), ParameterIDs::drive);
     addAndMakeVisible(*driveKnob);
     
+    sideDriveKnob = std::make_unique<KnobComponent>("SIDE DRIVE", audioProcessor.getValueTreeState(), ParameterIDs::sideDrive);
+    addAndMakeVisible(*sideDriveKnob);
+    
     mixKnob = std::make_unique<KnobComponent>("MIX", audioProcessor.getValueTreeState(), ParameterIDs::mix);
     addAndMakeVisible(*mixKnob);
     
@@ -117,11 +125,38 @@ void ProfessionalSaturationAudioProcessorEditor::setupComponents()
     saturationTypeCombo.addItem("Transistor Modern", 3);
     saturationTypeCombo.addItem("Diode Harsh", 4);
     saturationTypeCombo.addItem("Vintage Fuzz", 5);
+    saturationTypeCombo.addItem("Neural Model", 6);
     saturationTypeCombo.setLookAndFeel(&customLookAndFeel);
     addAndMakeVisible(saturationTypeCombo);
     saturationTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getValueTreeState(), ParameterIDs::satType, saturationTypeCombo);
     
+    // Mid/Side controls
+    stereoModeCombo.addItem("Stereo", 1);
+    stereoModeCombo.addItem("Mid/Side", 2);
+    stereoModeCombo.setLookAndFeel(&customLookAndFeel);
+    addAndMakeVisible(stereoModeCombo);
+    stereoModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), ParameterIDs::stereoMode, stereoModeCombo);
+    
+    sideSaturationTypeCombo.addItem("Side: Tube Warm", 1);
+    sideSaturationTypeCombo.addItem("Side: Tape Classic", 2);
+    sideSaturationTypeCombo.addItem("Side: Transistor Modern", 3);
+    sideSaturationTypeCombo.addItem("Side: Diode Harsh", 4);
+    sideSaturationTypeCombo.addItem("Side: Vintage Fuzz", 5);
+    sideSaturationTypeCombo.addItem("Side: Neural Model", 6);
+    sideSaturationTypeCombo.setLookAndFeel(&customLookAndFeel);
+    addAndMakeVisible(sideSaturationTypeCombo);
+    sideSaturationTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), ParameterIDs::sideSatType, sideSaturationTypeCombo);
+    
+    // Neural model loading; parsing happens here on the message thread
+    const auto modelName = audioProcessor.getNeuralModelName();
+    loadModelButton.setButtonText(modelName.isNotEmpty() ? modelName : "LOAD MODEL");
+    loadModelButton.setLookAndFeel(&customLookAndFeel);
+    loadModelButton.onClick = [this] { chooseNeuralModel(); };
+    addAndMakeVisible(loadModelButton);
+    
     soloButton.setButtonText("SOLO SAT");
     soloButton.setToggleable(true);
     soloButton.setLookAndFeel(&customLookAndFeel);
@@ -130,17 +165,82 @@ void ProfessionalSaturationAudioProcessorEditor::setupComponents()
         audioProcessor.getValueTreeState(), ParameterIDs::soloSaturation, soloButton);
     
     // Visualization components
-    inputVUMeter = std::make_unique<VUMeter>(VUMeter::Input, &audioProcessor.getSaturationProcessor());
+    inputVUMeter = std::make_unique<VUMeter>(VUMeter::Input, &audioProcessor.getMeterSnapshot());
     addAndMakeVisible(*inputVUMeter);
     
-    outputVUMeter = std::make_unique<VUMeter>(VUMeter::Output, nullptr, &audioProcessor.getLoudnessCompensator());
+    outputVUMeter = std::make_unique<VUMeter>(VUMeter::Output);
     addAndMakeVisible(*outputVUMeter);
     
-    saturationViz = std::make_unique<SaturationVisualization>(audioProcessor.getSaturationProcessor(), audioProcessor.getValueTreeState());
+    saturationViz = std::make_unique<SaturationVisualization>(audioProcessor, audioProcessor.getValueTreeState());
     addAndMakeVisible(*saturationViz);
     
-    eqDisplay = std::make_unique<EqualizerDisplay>(audioProcessor.getAdaptiveEqualizer());
+    eqDisplay = std::make_unique<EqualizerDisplay>(audioProcessor);
     addAndMakeVisible(*eqDisplay);
+    
+    // Diagnostics overlay, drawn over the EQ display
+    diagnosticsButton.setButtonText("CPU");
+    diagnosticsButton.setClickingTogglesState(true);
+    diagnosticsButton.setLookAndFeel(&customLookAndFeel);
+    diagnosticsButton.onClick = [this] { setDiagnosticsVisible(diagnosticsButton.getToggleState()); };
+    addAndMakeVisible(diagnosticsButton);
+    addChildComponent(stageProfileOverlay);
+}
+
+void ProfessionalSaturationAudioProcessorEditor::setDiagnosticsVisible(bool shouldBeVisible)
+{
+    audioProcessor.setStageProfilingEnabled(shouldBeVisible);
+    stageProfileOverlay.setVisible(shouldBeVisible);
+    
+    if (shouldBeVisible)
+    {
+        auto footprint = audioProcessor.getMemoryFootprint();
+        addMemoryUsage(footprint);
+        stageProfileOverlay.setMemoryFootprint(footprint);
+        stageProfileOverlay.toFront(false);
+    }
+}
+
+void ProfessionalSaturationAudioProcessorEditor::addMemoryUsage(MemoryFootprint& footprint) const
+{
+    size_t componentBytes = sizeof(*this);
+    
+    for (const auto& knob : { &inputGainKnob, &driveKnob, &sideDriveKnob, &mixKnob, &outputGainKnob,
+                              &lowCutKnob, &highCutKnob, &eqStrengthKnob, &eqSpeedKnob })
+        if (*knob != nullptr)
+            componentBytes += sizeof(KnobComponent);
+    
+    componentBytes += 2 * sizeof(VUMeter) + sizeof(SaturationVisualization) + sizeof(EqualizerDisplay);
+    
+    if (eqDisplay != nullptr)
+        componentBytes += eqDisplay->getMemoryUsage();
+    
+    footprint.add("Editor components", componentBytes);
+    
+    // Nothing is cached with setBufferedToImage(); the only image is the one the window
+    // peer renders into, 32 bits per physical pixel
+    const auto scale = static_cast<double>(juce::Component::getApproximateScaleFactorForComponent(this));
+    footprint.add("Editor backing image", static_cast<size_t>(getWidth() * scale) * static_cast<size_t>(getHeight() * scale) * 4);
+}
+
+void ProfessionalSaturationAudioProcessorEditor::chooseNeuralModel()
+{
+    modelChooser = std::make_unique<juce::FileChooser>("Load Neural Model", juce::File(), "*.json");
+    
+    modelChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                              [this](const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+        
+        if (file == juce::File())
+            return;
+        
+        juce::String error;
+        
+        if (audioProcessor.loadNeuralModel(file, error))
+            loadModelButton.setButtonText(audioProcessor.getNeuralModelName());
+        else
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Neural Model", error);
+    });
 }
 
 void ProfessionalSaturationAudioProcessorEditor::paint(juce::Graphics& g)
@@ -199,6 +299,11 @@ void ProfessionalSaturationAudioProcessorEditor::resized()
     // Position components
     titleLabel.setBounds(layout.titleArea);
     
+    auto diagnosticsArea = layout.titleArea;
+    diagnosticsButton.setBounds(diagnosticsArea.removeFromRight(static_cast<int>(48 * currentScaleFactor))
+                                               .withSizeKeepingCentre(static_cast<int>(48 * currentScaleFactor),
+                                                                      static_cast<int>(22 * currentScaleFactor)));
+    
     // VU Meters
     inputVUMeter->setBounds(layout.inputVUArea);
     outputVUMeter->setBounds(layout.outputVUArea);
@@ -206,6 +311,7 @@ void ProfessionalSaturationAudioProcessorEditor::resized()
     // Visualizations
     saturationViz->setBounds(layout.saturationVizArea);
     eqDisplay->setBounds(layout.eqDisplayArea);
+    stageProfileOverlay.setBounds(layout.eqDisplayArea);
     
     // Controls layout
     setupLayout();
@@ -213,9 +319,28 @@ void ProfessionalSaturationAudioProcessorEditor::resized()
 
 void ProfessionalSaturationAudioProcessorEditor::timerCallback()
 {
-    // Update VU meters with current levels
-    outputVUMeter->setLevels(audioProcessor.getOutputRMS(0), audioProcessor.getOutputRMS(1),
-                           audioProcessor.getOutputPeak(0), audioProcessor.getOutputPeak(1));
+    const Trace::ScopedEvent trace("Editor timer");
+    
+    // Follow bus layout changes made by the host while the editor is open
+    const auto layout = audioProcessor.getChannelLayoutOfBus(false, 0);
+    if (layout != meterLayout)
+    {
+        meterLayout = layout;
+        inputVUMeter->setChannelLayout(meterLayout);
+        outputVUMeter->setChannelLayout(meterLayout);
+    }
+    
+    // Update VU meters from one consistent meter frame
+    if (audioProcessor.getMeterSnapshot().read(meterFrame))
+    {
+        outputVUMeter->setLevels(meterFrame.outputRMS.data(), meterFrame.outputPeak.data(), meterFrame.numChannels);
+        
+        if (stageProfileOverlay.isVisible())
+        {
+            stageProfileOverlay.setFrame(meterFrame);
+            stageProfileOverlay.setDeadlineSummary(audioProcessor.getDeadlineMonitor().getSummary());
+        }
+    }
 }
 
 ProfessionalSaturationAudioProcessorEditor::ComponentBounds ProfessionalSaturationAudioProcessorEditor::calculateLayout(juce::Rectangle<int> bounds)
@@ -278,12 +403,14 @@ void ProfessionalSaturationAudioProcessorEditor::setupLayout()
     controlsBounds.removeFromTop(5);
     
     // Distribute knobs evenly
-    int knobWidth = controlsBounds.getWidth() / 4 - 10;
+    int knobWidth = controlsBounds.getWidth() / 5 - 10;
     
     inputGainKnob->setBounds(controlsBounds.removeFromLeft(knobWidth));
     controlsBounds.removeFromLeft(10);
     driveKnob->setBounds(controlsBounds.removeFromLeft(knobWidth));
     controlsBounds.removeFromLeft(10);
+    sideDriveKnob->setBounds(controlsBounds.removeFromLeft(knobWidth));
+    controlsBounds.removeFromLeft(10);
     mixKnob->setBounds(controlsBounds.removeFromLeft(knobWidth));
     controlsBounds.removeFromLeft(10);
     outputGainKnob->setBounds(controlsBounds);
@@ -323,12 +450,23 @@ void ProfessionalSaturationAudioProcessorEditor::setupLayout()
     satBounds.removeFromTop(5);
     
     auto satComboWidth = satBounds.getWidth() / 2 - 5;
-    saturationTypeCombo.setBounds(satBounds.removeFromLeft(satComboWidth));
-    satBounds.removeFromLeft(10);
-    soloButton.setBounds(satBounds.removeFromTop(30));
+    auto satRowHeight = juce::jmin(30, satBounds.getHeight() / 2 - 5);
+    
+    auto satTopRow = satBounds.removeFromTop(satRowHeight);
+    saturationTypeCombo.setBounds(satTopRow.removeFromLeft(satComboWidth));
+    satTopRow.removeFromLeft(10);
+    loadModelButton.setBounds(satTopRow.removeFromLeft(satTopRow.getWidth() / 2 - 5));
+    satTopRow.removeFromLeft(10);
+    soloButton.setBounds(satTopRow);
+    
+    satBounds.removeFromTop(10);
+    auto satBottomRow = satBounds.removeFromTop(satRowHeight);
+    stereoModeCombo.setBounds(satBottomRow.removeFromLeft(satComboWidth));
+    satBottomRow.removeFromLeft(10);
+    sideSaturationTypeCombo.setBounds(satBottomRow);
     
     // Scale knobs based on current scale factor
-    for (auto* knob : { inputGainKnob.get(), driveKnob.get(), mixKnob.get(), outputGainKnob.get(),
+    for (auto* knob : { inputGainKnob.get(), driveKnob.get(), sideDriveKnob.get(), mixKnob.get(), outputGainKnob.get(),
                        lowCutKnob.get(), highCutKnob.get(), eqStrengthKnob.get(), eqSpeedKnob.get() })
     {
         if (knob)
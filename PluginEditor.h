@@ -6,6 +6,7 @@
 #include "Components/VUMeter.h"
 #include "Components/SaturationVisualization.h"
 #include "Components/EqualizerDisplay.h"
+#include "Components/StageProfileOverlay.h"
 #include "LookAndFeel/CustomLookAndFeel.h"
 
 class ProfessionalSaturationAudioProcessorEditor : public juce::AudioProcessorEditor, public juce::Timer
@@ -17,10 +18,15 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
     void timerCallback() override;
+    
+    // Editor components and an estimate of the window's backing image, added to a footprint
+    void addMemoryUsage(MemoryFootprint& footprint) const;
 
 private:
     
     void setupComponents();
+    void chooseNeuralModel();
+    void setDiagnosticsVisible(bool shouldBeVisible);
     void setupLayout();
     
     struct ComponentBounds
@@ -40,12 +46,15 @@ private:
     juce::Rectangle<int> getScaledBounds(int baseWidthParam, int baseHeightParam, float scaleFactor = 1.0f);
     
     ProfessionalSaturationAudioProcessor& audioProcessor;
+    MeterFrame meterFrame;
+    juce::AudioChannelSet meterLayout = juce::AudioChannelSet::stereo();
     
     CustomLookAndFeel customLookAndFeel;
     
     // Control components
     std::unique_ptr<KnobComponent> inputGainKnob;
     std::unique_ptr<KnobComponent> driveKnob;
+    std::unique_ptr<KnobComponent> sideDriveKnob;
     std::unique_ptr<KnobComponent> mixKnob;
     std::unique_ptr<KnobComponent> outputGainKnob;
     
@@ -66,15 +75,27 @@ private:
     // Saturation controls
     juce::ComboBox saturationTypeCombo;
     juce::ToggleButton soloButton;
+    juce::TextButton loadModelButton;
+    std::unique_ptr<juce::FileChooser> modelChooser;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> saturationTypeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> soloAttachment;
     
+    // Mid/Side controls
+    juce::ComboBox stereoModeCombo;
+    juce::ComboBox sideSaturationTypeCombo;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sideSaturationTypeAttachment;
+    
     // Visualization components
     std::unique_ptr<VUMeter> inputVUMeter;
     std::unique_ptr<VUMeter> outputVUMeter;
     std::unique_ptr<SaturationVisualization> saturationViz;
     std::unique_ptr<EqualizerDisplay> eqDisplay;
     
+    // Diagnostics: per-stage CPU overlay, profiling runs only while it is shown
+    juce::TextButton diagnosticsButton;
+    StageProfileOverlay stageProfileOverlay;
+    
     // Labels and groupings
     juce::Label titleLabel;
     juce::Label saturationSectionLabel;
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "StateFormat.h"
 
 ProfessionalSaturationAudioProcessor::ProfessionalSaturationAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -21,6 +22,24 @@ ProfessionalSaturationAudioProcessor::ProfessionalSaturationAudioProcessor()
     outputGainParameter = valueTreeState.getRawParameterValue(ParameterIDs::outputGain);
     satTypeParameter = valueTreeState.getRawParameterValue(ParameterIDs::satType);
     soloSaturationParameter = valueTreeState.getRawParameterValue(ParameterIDs::soloSaturation);
+    tubeModelParameter = valueTreeState.getRawParameterValue(ParameterIDs::tubeModel);
+    tapeModelParameter = valueTreeState.getRawParameterValue(ParameterIDs::tapeModel);
+    
+    stereoModeParameter = valueTreeState.getRawParameterValue(ParameterIDs::stereoMode);
+    sideDriveParameter = valueTreeState.getRawParameterValue(ParameterIDs::sideDrive);
+    sideSatTypeParameter = valueTreeState.getRawParameterValue(ParameterIDs::sideSatType);
+    
+    numBandsParameter = valueTreeState.getRawParameterValue(ParameterIDs::numBands);
+    
+    for (size_t crossover = 0; crossover < crossoverFreqParameters.size(); ++crossover)
+        crossoverFreqParameters[crossover] = valueTreeState.getRawParameterValue(ParameterIDs::crossoverFreq[crossover]);
+    
+    for (size_t band = 0; band < bandDriveParameters.size(); ++band)
+    {
+        bandDriveParameters[band] = valueTreeState.getRawParameterValue(ParameterIDs::bandDrive[band]);
+        bandSatTypeParameters[band] = valueTreeState.getRawParameterValue(ParameterIDs::bandSatType[band]);
+        bandMixParameters[band] = valueTreeState.getRawParameterValue(ParameterIDs::bandMix[band]);
+    }
     
     lowCutFreqParameter = valueTreeState.getRawParameterValue(ParameterIDs::lowCutFreq);
     highCutFreqParameter = valueTreeState.getRawParameterValue(ParameterIDs::highCutFreq);
@@ -30,10 +49,34 @@ ProfessionalSaturationAudioProcessor::ProfessionalSaturationAudioProcessor()
     eqTargetCurveParameter = valueTreeState.getRawParameterValue(ParameterIDs::eqTargetCurve);
     eqAdaptionStrengthParameter = valueTreeState.getRawParameterValue(ParameterIDs::eqAdaptionStrength);
     eqReactionSpeedParameter = valueTreeState.getRawParameterValue(ParameterIDs::eqReactionSpeed);
+    
+    // Only reconfigure DSP modules whose parameters actually changed
+    for (auto* parameter : getParameters())
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            valueTreeState.addParameterListener(withID->paramID, this);
+    
+    deadlineLog = std::make_unique<DeadlineLog>(deadlineMonitor, [this](juce::uint64 configuration) { return describeConfiguration(configuration); });
+    
+    // Latency set on the audio thread reaches the host from the message thread
+    startTimer(latencyPollIntervalMs);
+    
+    // Tracing builds record a timeline for the lifetime of the first instance when asked to
+    const auto traceFile = juce::SystemStats::getEnvironmentVariable("PSAT_TRACE_FILE", {});
+    
+    if (traceFile.isNotEmpty() && juce::File::isAbsolutePath(traceFile))
+        ownsTraceRecording = Trace::startRecording(juce::File(traceFile));
 }
 
 ProfessionalSaturationAudioProcessor::~ProfessionalSaturationAudioProcessor()
 {
+    stopTimer();
+    
+    for (auto* parameter : getParameters())
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            valueTreeState.removeParameterListener(withID->paramID, this);
+    
+    if (ownsTraceRecording)
+        Trace::stopRecording();
 }
 
 const juce::String ProfessionalSaturationAudioProcessor::getName() const
@@ -70,7 +113,8 @@ bool ProfessionalSaturationAudioProcessor::isMidiEffect() const
 
 double ProfessionalSaturationAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    const auto sampleRate = getSampleRate();
+    return sampleRate > 0.0 ? tailLengthSamples.load() / sampleRate : 0.0;
 }
 
 int ProfessionalSaturationAudioProcessor::getNumPrograms()
@@ -106,31 +150,60 @@ void ProfessionalSaturationAudioProcessor::prepareToPlay(double sampleRate, int
     spec.numChannels = static_cast<uint32>(getTotalNumOutputChannels());
     spec.sampleRate = sampleRate;
     
-    // Prepare all DSP components
-    inputGain.prepare(spec);
-    preFilters.prepare(spec);
-    saturationProcessor.prepare(spec);
-    adaptiveEqualizer.prepare(spec);
-    postFilters.prepare(spec);
-    outputGain.prepare(spec);
-    loudnessCompensator.prepare(spec);
+    deadlineMonitor.prepare(sampleRate);
     
-    // Initialize processing buffers
-    dryBuffer.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
-    wetBuffer.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
+    // Split into per-pair lanes only when parallelism is requested and there is more than one pair
+    const bool useChannelLanes = channelParallelismEnabled && spec.numChannels > channelsPerLane;
+    const auto laneWidth = useChannelLanes ? channelsPerLane : size_t(0);
     
-    updateParameters();
+    // Gains ramp across one automation step
+    const auto stepSamples = automationSubBlockSize > 0 ? juce::jmin(automationSubBlockSize, samplesPerBlock) : samplesPerBlock;
+    const auto gainRampSeconds = sampleRate > 0.0 ? juce::jmax(1, stepSamples) / sampleRate : 0.0;
+    
+    // Prepare all DSP components of the active precision
+    if (isUsingDoublePrecision())
+        doubleChain.prepare(spec, gainRampSeconds, laneWidth);
+    else
+        floatChain.prepare(spec, gainRampSeconds, laneWidth);
+    
+    // Freshly built lanes have no model yet
+    applyNeuralModels();
+    
+    // The callback thread runs one lane itself, workers take the rest
+    const auto numLanes = isUsingDoublePrecision() ? doubleChain.getNumLanes() : floatChain.getNumLanes();
+    const auto workgroup = [this] { const juce::ScopedLock lock(audioWorkgroupLock); return audioWorkgroup; }();
+    channelWorkers.prepare(useChannelLanes ? juce::jmin(maxChannelWorkers, static_cast<int>(numLanes) - 1) : 0,
+                           sampleRate, samplesPerBlock, workgroup);
+    
+    dirtyParameters.store(allDirty);
+    silentInputSamples = 0;
+    outputAtRest = false;
+    restOutputLevels.assign(static_cast<size_t>(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels())), 0.0);
+    
+    if (isUsingDoublePrecision())
+        jumpToParameters(doubleChain);
+    else
+        jumpToParameters(floatChain);
+    
+    deadlineMonitor.setConfiguration(packConfiguration());
+    
+    // Hosts read the latency right after prepareToPlay(), so it cannot wait for the message thread
+    setLatencySamples(reportedLatencySamples.load(std::memory_order_relaxed));
+    
+    DBG("Memory footprint after prepareToPlay():" << juce::newLine << getMemoryFootprint().toString());
+}
+
+void ProfessionalSaturationAudioProcessor::audioWorkgroupContextChanged(const juce::AudioWorkgroup& workgroup)
+{
+    const juce::ScopedLock workgroupLock(audioWorkgroupLock);
+    audioWorkgroup = workgroup;
 }
 
 void ProfessionalSaturationAudioProcessor::releaseResources()
 {
-    inputGain.reset();
-    preFilters.reset();
-    saturationProcessor.reset();
-    adaptiveEqualizer.reset();
-    postFilters.reset();
-    outputGain.reset();
-    loudnessCompensator.reset();
+    channelWorkers.release();
+    floatChain.reset();
+    doubleChain.reset();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -140,8 +213,13 @@ bool ProfessionalSaturationAudioProcessor::isBusesLayoutSupported(const BusesLay
     juce::ignoreUnused(layouts);
     return true;
   #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    
+    if (mainOutput != juce::AudioChannelSet::mono()
+     && mainOutput != juce::AudioChannelSet::stereo()
+     && mainOutput != juce::AudioChannelSet::create5point1()
+     && mainOutput != juce::AudioChannelSet::create7point1()
+     && mainOutput != juce::AudioChannelSet::create7point1point4())
         return false;
 
    #if ! JucePlugin_IsSynth
@@ -157,90 +235,355 @@ bool ProfessionalSaturationAudioProcessor::isBusesLayoutSupported(const BusesLay
 void ProfessionalSaturationAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer, floatChain, false);
+}
+
+void ProfessionalSaturationAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer, doubleChain, false);
+}
+
+void ProfessionalSaturationAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer, floatChain, true);
+}
+
+void ProfessionalSaturationAudioProcessor::processBlockBypassed(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer, doubleChain, true);
+}
+
+template <typename SampleType>
+void ProfessionalSaturationAudioProcessor::processBlockInternal(juce::AudioBuffer<SampleType>& buffer, ProcessingChain<SampleType>& chain, bool bypassed)
+{
     juce::ScopedNoDenormals noDenormals;
+    const RealtimeSafety::ScopedAudioThread audioThreadScope;
+    const DeadlineMonitor::ScopedBlock deadlineScope(deadlineMonitor, buffer.getNumSamples(), isNonRealtime());
+    const Trace::ScopedEvent blockTrace("processBlock");
     
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
+    auto numMeteredChannels = juce::jmin(totalNumInputChannels, static_cast<int>(MeterFrame::maxChannels));
     
     // Clear unused output channels
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
     
-    // Update parameters
-    updateParameters();
-    
     // Create audio block for processing
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    juce::dsp::AudioBlock<const SampleType> inputBlock(buffer);
     
-    // Store dry signal for loudness compensation analysis
-    dryBuffer.makeCopyOf(buffer);
-    juce::dsp::AudioBlock<const float> dryBlock(dryBuffer);
-    loudnessCompensator.analyzeInput(dryBlock);
+    // The bypass keeps its input history current in every state
+    const bool leavingBypass = chain.bypass.setBypassed(bypassed);
+    chain.bypass.pushInput(inputBlock);
     
-    // Measure input levels
-    for (int channel = 0; channel < totalNumInputChannels && channel < 2; ++channel)
+    // Fully bypassed: only the dry delay line runs
+    if (chain.bypass.isFullyBypassed())
     {
-        auto* channelData = buffer.getReadPointer(channel);
-        float rms = 0.0f;
-        float peak = 0.0f;
-        
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            float sampleValue = std::abs(channelData[sample]);
-            rms += channelData[sample] * channelData[sample];
-            peak = juce::jmax(peak, sampleValue);
-        }
-        
-        rms = std::sqrt(rms / buffer.getNumSamples());
+        chain.bypass.processBypassed(block);
+        return;
+    }
+    
+    // Pick up a newly loaded neural model before any lane runs
+    if (neuralModelGeneration.load(std::memory_order_acquire) != appliedNeuralModelGeneration.load(std::memory_order_relaxed))
+        applyNeuralModels();
+    
+    // Stage timers follow the diagnostics switch; a fresh profile starts each time it turns on
+    const bool profiling = stageProfilingEnabled.load(std::memory_order_relaxed);
+    
+    if (profiling && !chain.chainTimer.isEnabled())
+        chain.stageProfiler.reset();
+    
+    chain.chainTimer.setEnabled(profiling);
+    
+    for (auto& lane : chain.lanes)
+        lane->stageTimer.setEnabled(profiling);
+    
+    if (leavingBypass)
+        warmUpChain(chain);
+    
+    // Measure input levels and loudness in a single pass, before anything modifies the buffer
+    chain.chainTimer.start();
+    chain.inputMeter.process(inputBlock);
+    chain.loudnessCompensator.analyzeInput(chain.inputMeter);
+    chain.chainTimer.lap(StageProfile::compensation);
+    
+    for (int channel = 0; channel < numMeteredChannels; ++channel)
+    {
+        float rms = chain.inputMeter.getRMS(channel);
+        float peak = chain.inputMeter.getPeak(channel);
         inputRMSLevels[static_cast<size_t>(channel)] = inputRMSLevels[static_cast<size_t>(channel)] * 0.9f + rms * 0.1f;
         inputPeakLevels[static_cast<size_t>(channel)] = inputPeakLevels[static_cast<size_t>(channel)] * 0.9f + peak * 0.1f;
     }
     
-    // Processing chain
-    // 1. Input gain
-    inputGain.process(context);
+    const auto numSamples = block.getNumSamples();
     
-    // 2. Pre-filtering (anti-aliasing)
-    preFilters.process(context);
+    // New parameter values are read once per host block; the lanes ramp to them across it
+    const bool parametersChanged = updateParameters(chain);
     
-    // 3. Saturation processing
-    saturationProcessor.process(context);
+    // New settings move the rest level, so the chain has to run and settle again first
+    if (parametersChanged)
+    {
+        outputAtRest = false;
+        silentInputSamples = 0;
+        deadlineMonitor.setConfiguration(packConfiguration());
+    }
     
-    // 4. Adaptive EQ (post-saturation)
-    adaptiveEqualizer.process(context);
+    // Idle fast-path: after the tail of the last sound has decayed, a silent input
+    // block can only reproduce the rest level, so skip the chain. The input meter's
+    // block peak doubles as the silence detector.
+    const bool inputSilent = chain.inputMeter.getBlockPeak() == 0.0f;
+    const bool idle = inputSilent && outputAtRest && silentInputSamples >= tailLengthSamples.load(std::memory_order_relaxed);
+    silentInputSamples = inputSilent ? silentInputSamples + static_cast<juce::int64>(numSamples) : 0;
     
-    // 5. Post-filtering
-    postFilters.process(context);
+    if (idle)
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            block.getSingleChannelBlock(channel).fill(static_cast<SampleType>(restOutputLevels[channel]));
+    }
+    else
+    {
+        const auto stepSize = static_cast<size_t>(automationSubBlockSize);
+        
+        if (channelWorkers.getNumWorkers() > 0)
+        {
+            auto processLane = [&chain, &block, stepSize](int laneIndex) { chain.processLane(static_cast<size_t>(laneIndex), block, stepSize); };
+            channelWorkers.run(static_cast<int>(chain.getNumLanes()), processLane);
+        }
+        else
+        {
+            chain.process(block, stepSize);
+        }
+    }
     
-    // 6. Output gain
-    outputGain.process(context);
+    if (parametersChanged)
+        updateLatencyAndTail(chain);
     
-    // Analyze output for loudness compensation
-    juce::dsp::AudioBlock<const float> outputBlock(buffer);
-    loudnessCompensator.analyzeOutput(outputBlock);
+    // Measure output levels and loudness in a single pass
+    chain.chainTimer.start();
+    juce::dsp::AudioBlock<const SampleType> outputBlock(buffer);
+    chain.outputMeter.process(outputBlock);
+    chain.loudnessCompensator.analyzeOutput(chain.outputMeter);
+    outputAtRest = inputSilent && captureRestOutput(block);
     
     // Apply loudness compensation
-    loudnessCompensator.applyCompensation(block);
+    chain.loudnessCompensator.applyCompensation(block);
+    
+    chain.chainTimer.lap(StageProfile::compensation);
     
-    // Measure output levels
-    for (int channel = 0; channel < totalNumInputChannels && channel < 2; ++channel)
+    // Lanes have all joined by now, so their timers can be read from this thread
+    if (profiling)
     {
-        auto* channelData = buffer.getReadPointer(channel);
-        float rms = 0.0f;
-        float peak = 0.0f;
+        StageProfile::Nanoseconds blockNanoseconds {};
+        chain.chainTimer.drainInto(blockNanoseconds);
         
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            float sampleValue = std::abs(channelData[sample]);
-            rms += channelData[sample] * channelData[sample];
-            peak = juce::jmax(peak, sampleValue);
-        }
+        for (auto& lane : chain.lanes)
+            lane->stageTimer.drainInto(blockNanoseconds);
         
-        rms = std::sqrt(rms / buffer.getNumSamples());
+        chain.stageProfiler.addBlock(blockNanoseconds, static_cast<int>(numSamples));
+    }
+    
+    // Crossfade to or from the latency-matched dry signal
+    if (chain.bypass.isFading())
+        chain.bypass.mixDry(block);
+    
+    // Output levels follow the compensation gain instead of rescanning the buffer
+    const float compensation = chain.loudnessCompensator.getAppliedGain();
+    
+    for (int channel = 0; channel < numMeteredChannels; ++channel)
+    {
+        float rms = chain.outputMeter.getRMS(channel) * compensation;
+        float peak = chain.outputMeter.getPeak(channel) * compensation;
         outputRMSLevels[static_cast<size_t>(channel)] = outputRMSLevels[static_cast<size_t>(channel)] * 0.9f + rms * 0.1f;
         outputPeakLevels[static_cast<size_t>(channel)] = outputPeakLevels[static_cast<size_t>(channel)] * 0.9f + peak * 0.1f;
+        outputTruePeakLevels[static_cast<size_t>(channel)] = chain.outputMeter.getTruePeak(channel) * compensation;
     }
+    
+    publishMeters(chain, numMeteredChannels);
+}
+
+template <typename SampleType>
+void ProfessionalSaturationAudioProcessor::warmUpChain(ProcessingChain<SampleType>& chain)
+{
+    // The chain has been idle for the whole bypass. It now runs on live input while the
+    // bypass keeps the dry signal in the output, and the crossfade back starts once the
+    // filter and oversampler states are current (see LatencyCompensatedBypass)
+    jumpToParameters(chain);
+    
+    silentInputSamples = 0;
+    outputAtRest = false;
+}
+
+template <typename SampleType>
+bool ProfessionalSaturationAudioProcessor::captureRestOutput(const juce::dsp::AudioBlock<SampleType>& block)
+{
+    const auto numSamples = block.getNumSamples();
+    
+    if (numSamples == 0 || block.getNumChannels() > restOutputLevels.size())
+        return false;
+    
+    bool atRest = true;
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        const auto* data = block.getChannelPointer(channel);
+        const auto restLevel = data[numSamples - 1];
+        restOutputLevels[channel] = static_cast<double>(restLevel);
+        
+        for (size_t sample = 0; sample < numSamples && atRest; ++sample)
+            atRest = std::abs(static_cast<double>(data[sample] - restLevel)) <= restTolerance;
+    }
+    
+    return atRest;
+}
+
+void ProfessionalSaturationAudioProcessor::applyNeuralModels()
+{
+    // Read the generation first: the pointer loaded after it is at least that new
+    const auto generation = neuralModelGeneration.load(std::memory_order_acquire);
+    const auto* models = publishedNeuralModels.load(std::memory_order_acquire);
+    
+    for (auto& lane : floatChain.lanes)
+        lane->saturationProcessor.setNeuralModel(models != nullptr ? models->floatModel.get() : nullptr);
+    
+    for (auto& lane : doubleChain.lanes)
+        lane->saturationProcessor.setNeuralModel(models != nullptr ? models->doubleModel.get() : nullptr);
+    
+    appliedNeuralModelGeneration.store(generation, std::memory_order_release);
+}
+
+bool ProfessionalSaturationAudioProcessor::loadNeuralModel(const juce::File& file, juce::String& error)
+{
+    auto models = std::make_unique<NeuralModels>();
+    models->floatModel = NeuralAmpModel<float>::loadFromFile(file, error);
+    
+    if (models->floatModel == nullptr)
+        return false;
+    
+    models->doubleModel = NeuralAmpModel<double>::loadFromFile(file, error);
+    
+    if (models->doubleModel == nullptr)
+        return false;
+    
+    const juce::ScopedLock lock(neuralModelLock);
+    
+    // Models older than the one the audio thread last acknowledged are no longer referenced
+    const auto applied = appliedNeuralModelGeneration.load(std::memory_order_acquire);
+    neuralModelHistory.erase(std::remove_if(neuralModelHistory.begin(), neuralModelHistory.end(),
+                                            [applied](const auto& entry) { return entry.first < applied; }),
+                             neuralModelHistory.end());
+    
+    const auto generation = neuralModelGeneration.load() + 1;
+    neuralModelName = models->floatModel->getName();
+    publishedNeuralModels.store(models.get(), std::memory_order_release);
+    neuralModelHistory.emplace_back(generation, std::move(models));
+    neuralModelGeneration.store(generation, std::memory_order_release);
+    
+    // Saved with the plugin state so the model reloads with the session
+    valueTreeState.state.setProperty(neuralModelPathProperty, file.getFullPathName(), nullptr);
+    return true;
+}
+
+juce::String ProfessionalSaturationAudioProcessor::getNeuralModelName() const
+{
+    const juce::ScopedLock lock(neuralModelLock);
+    return neuralModelName;
+}
+
+namespace
+{
+    // Discrete parameters in the configuration code, four bits each in bits 0-27
+    const juce::String* const configurationParameterIDs[] = { &ParameterIDs::satType, &ParameterIDs::tubeModel, &ParameterIDs::tapeModel,
+                                                               &ParameterIDs::stereoMode, &ParameterIDs::numBands, &ParameterIDs::filterEnabled,
+                                                               &ParameterIDs::eqEnabled };
+    
+    constexpr int sampleRateShift = 28;   // 20 bits, in Hz
+    constexpr int channelsShift = 48;     // 6 bits
+    constexpr int doubleShift = 54;
+    constexpr int parallelShift = 55;
+}
+
+juce::uint64 ProfessionalSaturationAudioProcessor::packConfiguration() const noexcept
+{
+    // Raw parameter values only, so this is safe on the audio thread
+    const std::atomic<float>* const values[] = { satTypeParameter, tubeModelParameter, tapeModelParameter, stereoModeParameter,
+                                                 numBandsParameter, filterEnabledParameter, eqEnabledParameter };
+    static_assert(std::size(values) == std::size(configurationParameterIDs), "Every packed parameter needs its ID");
+    
+    juce::uint64 configuration = 0;
+    
+    for (size_t i = 0; i < std::size(values); ++i)
+        if (values[i] != nullptr)
+            configuration |= static_cast<juce::uint64>(juce::jlimit(0, 15, juce::roundToInt(values[i]->load()))) << (4 * i);
+    
+    configuration |= static_cast<juce::uint64>(juce::jlimit(0, 0xfffff, juce::roundToInt(getSampleRate()))) << sampleRateShift;
+    configuration |= static_cast<juce::uint64>(juce::jlimit(0, 63, getTotalNumOutputChannels())) << channelsShift;
+    configuration |= static_cast<juce::uint64>(isUsingDoublePrecision() ? 1 : 0) << doubleShift;
+    configuration |= static_cast<juce::uint64>(channelParallelismEnabled ? 1 : 0) << parallelShift;
+    return configuration;
+}
+
+juce::String ProfessionalSaturationAudioProcessor::describeConfiguration(juce::uint64 configuration) const
+{
+    const auto field = [configuration](int shift, juce::uint64 mask) { return static_cast<int>((configuration >> shift) & mask); };
+    
+    juce::String description;
+    description << field(sampleRateShift, 0xfffff) << " Hz, "
+                << (field(doubleShift, 1) != 0 ? "double" : "float") << ", "
+                << field(channelsShift, 63) << " ch" << (field(parallelShift, 1) != 0 ? " parallel" : "");
+    
+    for (size_t i = 0; i < std::size(configurationParameterIDs); ++i)
+    {
+        const auto& id = *configurationParameterIDs[i];
+        
+        if (auto* parameter = valueTreeState.getParameter(id))
+            description << ", " << id << "=" << parameter->getText(parameter->convertTo0to1(static_cast<float>(field(static_cast<int>(4 * i), 15))), 0);
+    }
+    
+    return description;
+}
+
+MemoryFootprint ProfessionalSaturationAudioProcessor::getMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.add("Processor", sizeof(*this));
+    
+    // The chain not in use still holds whatever it was last prepared with
+    floatChain.addMemoryUsage(footprint);
+    doubleChain.addMemoryUsage(footprint);
+    return footprint;
+}
+
+void ProfessionalSaturationAudioProcessor::setAutomationSubBlockSize(int numSamples)
+{
+    automationSubBlockSize = juce::jmax(0, numSamples);
+}
+
+float ProfessionalSaturationAudioProcessor::getSaturationCurveValue(float input) const
+{
+    return isUsingDoublePrecision() ? doubleChain.getPrimaryLane().saturationProcessor.getSaturationCurveValue(input)
+                                    : floatChain.getPrimaryLane().saturationProcessor.getSaturationCurveValue(input);
+}
+
+std::vector<float> ProfessionalSaturationAudioProcessor::getEqualizerFrequencyResponse() const
+{
+    return isUsingDoublePrecision() ? doubleChain.getPrimaryLane().adaptiveEqualizer.getFrequencyResponse()
+                                    : floatChain.getPrimaryLane().adaptiveEqualizer.getFrequencyResponse();
+}
+
+std::vector<float> ProfessionalSaturationAudioProcessor::getEqualizerTargetCurve() const
+{
+    return isUsingDoublePrecision() ? doubleChain.getPrimaryLane().adaptiveEqualizer.getTargetCurve()
+                                    : floatChain.getPrimaryLane().adaptiveEqualizer.getTargetCurve();
+}
+
+std::vector<float> ProfessionalSaturationAudioProcessor::getEqualizerSpectrum() const
+{
+    return isUsingDoublePrecision() ? doubleChain.getPrimaryLane().adaptiveEqualizer.getCurrentSpectrum()
+                                    : floatChain.getPrimaryLane().adaptiveEqualizer.getCurrentSpectrum();
 }
 
 bool ProfessionalSaturationAudioProcessor::hasEditor() const
@@ -255,92 +598,235 @@ juce::AudioProcessorEditor* ProfessionalSaturationAudioProcessor::createEditor()
 
 void ProfessionalSaturationAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = valueTreeState.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Binary rather than XML: sessions with many instances save and load noticeably faster
+    StateFormat::write(valueTreeState, destData);
 }
 
 void ProfessionalSaturationAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    if (StateFormat::isBinaryState(data, sizeInBytes))
+    {
+        if (! StateFormat::read(valueTreeState, data, sizeInBytes))
+            return;
+    }
+    else
+    {
+        // Sessions and presets saved by earlier releases hold XML
+        std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+        
+        if (xmlState == nullptr || !xmlState->hasTagName(valueTreeState.state.getType()))
+            return;
+        
+        valueTreeState.replaceState(juce::ValueTree::fromXml(*xmlState));
+    }
+    
+    const auto modelPath = valueTreeState.state.getProperty(neuralModelPathProperty).toString();
+    
+    if (modelPath.isNotEmpty() && juce::File::isAbsolutePath(modelPath))
+    {
+        juce::String error;
+        loadNeuralModel(juce::File(modelPath), error);
+    }
+}
 
-    if (xmlState.get() != nullptr)
-        if (xmlState->hasTagName(valueTreeState.state.getType()))
-            valueTreeState.replaceState(juce::ValueTree::fromXml(*xmlState));
+void ProfessionalSaturationAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(newValue);
+    Trace::instant("Parameter change", parameterID);
+    dirtyParameters.fetch_or(getDirtyFlagForParameter(parameterID));
 }
 
-void ProfessionalSaturationAudioProcessor::updateParameters()
+uint32 ProfessionalSaturationAudioProcessor::getDirtyFlagForParameter(const juce::String& parameterID)
 {
-    // Update input/output gains
-    if (inputGainParameter)
-        inputGain.setGainDecibels(inputGainParameter->load());
-    
-    if (outputGainParameter)
-        outputGain.setGainDecibels(outputGainParameter->load());
-    
-    // Update saturation processor
-    if (driveParameter)
-        saturationProcessor.setDrive(driveParameter->load());
-    
-    if (mixParameter)
-        saturationProcessor.setMix(mixParameter->load());
+    if (parameterID == ParameterIDs::inputGain || parameterID == ParameterIDs::outputGain)
+        return gainsDirty;
+    
+    if (parameterID == ParameterIDs::drive || parameterID == ParameterIDs::mix
+     || parameterID == ParameterIDs::satType || parameterID == ParameterIDs::soloSaturation
+     || parameterID == ParameterIDs::tubeModel || parameterID == ParameterIDs::tapeModel
+     || parameterID == ParameterIDs::stereoMode || parameterID == ParameterIDs::sideDrive
+     || parameterID == ParameterIDs::sideSatType || parameterID == ParameterIDs::numBands
+     || parameterID.startsWith("crossover") || parameterID.startsWith("band"))
+        return saturationDirty;
+    
+    if (parameterID == ParameterIDs::lowCutFreq || parameterID == ParameterIDs::highCutFreq
+     || parameterID == ParameterIDs::filterEnabled)
+        return filtersDirty;
+    
+    if (parameterID == ParameterIDs::eqEnabled || parameterID == ParameterIDs::eqTargetCurve
+     || parameterID == ParameterIDs::eqAdaptionStrength || parameterID == ParameterIDs::eqReactionSpeed)
+        return equalizerDirty;
+    
+    return allDirty;
+}
+
+template <typename SampleType>
+bool ProfessionalSaturationAudioProcessor::updateParameters(ProcessingChain<SampleType>& chain)
+{
+    using Chain = ProcessingChain<SampleType>;
+    static_assert(Chain::maxBands == ParameterIDs::maxBands, "Band parameters must map one to one onto the chain");
     
-    if (satTypeParameter)
-        saturationProcessor.setSaturationType(static_cast<int>(satTypeParameter->load()));
+    auto& automation = chain.automation;
+    automation.jumpToEnd();
     
-    if (soloSaturationParameter)
-        saturationProcessor.setSoloMode(soloSaturationParameter->load() > 0.5f);
+    const auto dirty = dirtyParameters.exchange(0);
     
-    // Update linear phase filters
-    if (filterEnabledParameter)
-        preFilters.setEnabled(filterEnabledParameter->load() > 0.5f);
+    if (dirty == 0)
+        return false;
     
-    if (lowCutFreqParameter)
-        preFilters.setLowCutFrequency(lowCutFreqParameter->load());
+    auto setTarget = [&automation](int parameter, const std::atomic<float>* value)
+    {
+        if (value != nullptr)
+            automation.end[static_cast<size_t>(parameter)] = value->load();
+    };
     
-    if (highCutFreqParameter)
-        postFilters.setHighCutFrequency(highCutFreqParameter->load());
+    // Continuous parameters only get new targets here; the lanes ramp to them while processing
+    if ((dirty & gainsDirty) != 0)
+    {
+        setTarget(Chain::inputGainDb, inputGainParameter);
+        setTarget(Chain::outputGainDb, outputGainParameter);
+    }
     
-    // Update adaptive equalizer
-    if (eqEnabledParameter)
-        adaptiveEqualizer.setEnabled(eqEnabledParameter->load() > 0.5f);
+    if ((dirty & saturationDirty) != 0)
+    {
+        setTarget(Chain::drive, driveParameter);
+        setTarget(Chain::mix, mixParameter);
+        setTarget(Chain::sideDrive, sideDriveParameter);
+        
+        for (size_t crossover = 0; crossover < crossoverFreqParameters.size(); ++crossover)
+            setTarget(Chain::firstCrossoverFrequency + static_cast<int>(crossover), crossoverFreqParameters[crossover]);
+        
+        for (size_t band = 0; band < bandDriveParameters.size(); ++band)
+        {
+            setTarget(Chain::firstBandDrive + static_cast<int>(band), bandDriveParameters[band]);
+            setTarget(Chain::firstBandMix + static_cast<int>(band), bandMixParameters[band]);
+        }
+    }
     
-    if (eqTargetCurveParameter)
-        adaptiveEqualizer.setTargetCurve(static_cast<int>(eqTargetCurveParameter->load()));
+    if ((dirty & filtersDirty) != 0)
+    {
+        setTarget(Chain::lowCutFrequency, lowCutFreqParameter);
+        setTarget(Chain::highCutFrequency, highCutFreqParameter);
+    }
     
-    if (eqAdaptionStrengthParameter)
-        adaptiveEqualizer.setAdaptionStrength(eqAdaptionStrengthParameter->load());
+    // Switches and choices take effect at the start of the block; every lane gets the same settings
+    for (auto& lane : chain.lanes)
+    {
+        // Update saturation processor
+        if ((dirty & saturationDirty) != 0)
+        {
+            if (satTypeParameter)
+                lane->saturationProcessor.setSaturationType(static_cast<int>(satTypeParameter->load()));
+            
+            if (soloSaturationParameter)
+                lane->saturationProcessor.setSoloMode(soloSaturationParameter->load() > 0.5f);
+            
+            if (tubeModelParameter)
+                lane->saturationProcessor.setTubeModel(static_cast<int>(tubeModelParameter->load()));
+            
+            if (tapeModelParameter)
+                lane->saturationProcessor.setTapeModel(static_cast<int>(tapeModelParameter->load()));
+            
+            // M/S only makes sense on a plain stereo bus, not on surround channel pairs
+            if (stereoModeParameter)
+                lane->saturationProcessor.setStereoMode(chain.getNumLanes() == 1 && lane->numChannels == 2
+                                                            ? static_cast<int>(stereoModeParameter->load())
+                                                            : static_cast<int>(SaturationProcessor<SampleType>::LeftRight));
+            
+            if (sideSatTypeParameter)
+                lane->saturationProcessor.setSideSaturationType(static_cast<int>(sideSatTypeParameter->load()));
+            
+            // Choice index 0 is single band, 1-3 map to 2-4 bands
+            if (numBandsParameter)
+                lane->saturationProcessor.setNumBands(static_cast<int>(numBandsParameter->load()) + 1);
+            
+            for (size_t band = 0; band < bandSatTypeParameters.size(); ++band)
+                if (bandSatTypeParameters[band])
+                    lane->saturationProcessor.setBandSaturationType(static_cast<int>(band), static_cast<int>(bandSatTypeParameters[band]->load()));
+        }
+        
+        // Update linear phase filters
+        if ((dirty & filtersDirty) != 0)
+        {
+            if (filterEnabledParameter)
+                lane->preFilters.setEnabled(filterEnabledParameter->load() > 0.5f);
+        }
+        
+        // Update adaptive equalizer
+        if ((dirty & equalizerDirty) != 0)
+        {
+            if (eqEnabledParameter)
+                lane->adaptiveEqualizer.setEnabled(eqEnabledParameter->load() > 0.5f);
+            
+            if (eqTargetCurveParameter)
+                lane->adaptiveEqualizer.setTargetCurve(static_cast<int>(eqTargetCurveParameter->load()));
+            
+            if (eqAdaptionStrengthParameter)
+                lane->adaptiveEqualizer.setAdaptionStrength(eqAdaptionStrengthParameter->load());
+            
+            if (eqReactionSpeedParameter)
+                lane->adaptiveEqualizer.setReactionSpeed(eqReactionSpeedParameter->load());
+        }
+    }
     
-    if (eqReactionSpeedParameter)
-        adaptiveEqualizer.setReactionSpeed(eqReactionSpeedParameter->load());
+    return true;
 }
 
-float ProfessionalSaturationAudioProcessor::getInputRMS(int channel) const
+template <typename SampleType>
+void ProfessionalSaturationAudioProcessor::jumpToParameters(ProcessingChain<SampleType>& chain)
 {
-    if (channel >= 0 && channel < 2)
-        return inputRMSLevels[static_cast<size_t>(channel)];
-    return 0.0f;
+    updateParameters(chain);
+    chain.finishAutomation();
+    updateLatencyAndTail(chain);
 }
 
-float ProfessionalSaturationAudioProcessor::getInputPeak(int channel) const
+template <typename SampleType>
+void ProfessionalSaturationAudioProcessor::updateLatencyAndTail(ProcessingChain<SampleType>& chain)
 {
-    if (channel >= 0 && channel < 2)
-        return inputPeakLevels[static_cast<size_t>(channel)];
-    return 0.0f;
+    // Latency and tails depend on which filters and models are active
+    const auto latency = chain.getLatencySamples();
+    chain.bypass.setLatency(latency);
+    tailLengthSamples.store(chain.getTailLengthSamples(), std::memory_order_relaxed);
+    
+    // Only switching the linear-phase filters on or off changes it; the timer passes it on
+    reportedLatencySamples.store(latency, std::memory_order_relaxed);
 }
 
-float ProfessionalSaturationAudioProcessor::getOutputRMS(int channel) const
+void ProfessionalSaturationAudioProcessor::timerCallback()
 {
-    if (channel >= 0 && channel < 2)
-        return outputRMSLevels[static_cast<size_t>(channel)];
-    return 0.0f;
+    const auto latency = reportedLatencySamples.load(std::memory_order_relaxed);
+    
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
 }
 
-float ProfessionalSaturationAudioProcessor::getOutputPeak(int channel) const
+template <typename SampleType>
+void ProfessionalSaturationAudioProcessor::publishMeters(ProcessingChain<SampleType>& chain, int numChannels)
 {
-    if (channel >= 0 && channel < 2)
-        return outputPeakLevels[static_cast<size_t>(channel)];
-    return 0.0f;
+    MeterFrame frame;
+    frame.numChannels = static_cast<uint32>(juce::jlimit(0, static_cast<int>(MeterFrame::maxChannels), numChannels));
+    
+    for (size_t channel = 0; channel < frame.numChannels; ++channel)
+    {
+        frame.inputRMS[channel] = inputRMSLevels[channel];
+        frame.inputPeak[channel] = inputPeakLevels[channel];
+        frame.outputRMS[channel] = outputRMSLevels[channel];
+        frame.outputPeak[channel] = outputPeakLevels[channel];
+        frame.outputTruePeak[channel] = outputTruePeakLevels[channel];
+        frame.saturationRMS[channel] = chain.getSaturationRMS(channel);
+        frame.saturationPeak[channel] = chain.getSaturationPeak(channel);
+    }
+    
+    frame.inputLUFS = MeterSnapshot::gainToLUFS(chain.loudnessCompensator.getInputLoudness());
+    frame.outputLUFS = MeterSnapshot::gainToLUFS(chain.loudnessCompensator.getOutputLoudness());
+    frame.compensationGainDb = chain.loudnessCompensator.getCompensationGain();
+    
+    frame.stageProfilingEnabled = chain.chainTimer.isEnabled();
+    frame.stageAverageLoad = chain.stageProfiler.getAverageLoad();
+    frame.stageWorstLoad = chain.stageProfiler.getWorstLoad();
+    frame.worstBlockLoad = chain.stageProfiler.getWorstTotalLoad();
+    
+    meterSnapshot.publish(frame);
 }
 
 // This creates new instances of the plugin
@@ -2,12 +2,16 @@
 
 #include <JuceHeader.h>
 #include "Parameters.h"
-#include "DSP/SaturationProcessor.h"
-#include "DSP/AdaptiveEqualizer.h"
-#include "DSP/LinearPhaseFilters.h"
-#include "DSP/LoudnessCompensator.h"
+#include "DSP/ProcessingChain.h"
+#include "DSP/ChannelWorkerPool.h"
+#include "DSP/MeterSnapshot.h"
+#include "DSP/RealtimeSafety.h"
+#include "DSP/DeadlineMonitor.h"
+#include "DSP/TraceRecorder.h"
 
-class ProfessionalSaturationAudioProcessor : public juce::AudioProcessor
+class ProfessionalSaturationAudioProcessor : public juce::AudioProcessor,
+                                             private juce::AudioProcessorValueTreeState::Listener,
+                                             private juce::Timer
 {
 public:
     ProfessionalSaturationAudioProcessor();
@@ -21,6 +25,15 @@ public:
 #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    // Host bypass: latency-matched dry signal with a short crossfade
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    
+    // Channel workers join the host's audio workgroup at the next prepareToPlay()
+    void audioWorkgroupContextChanged(const juce::AudioWorkgroup& workgroup) override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -43,30 +56,103 @@ public:
 
     // Accessors for UI components
     juce::AudioProcessorValueTreeState& getValueTreeState() { return valueTreeState; }
-    SaturationProcessor& getSaturationProcessor() { return saturationProcessor; }
-    AdaptiveEqualizer& getAdaptiveEqualizer() { return adaptiveEqualizer; }
-    LoudnessCompensator& getLoudnessCompensator() { return loudnessCompensator; }
     
-    // Level monitoring
-    float getInputRMS(int channel) const;
-    float getInputPeak(int channel) const;
-    float getOutputRMS(int channel) const;
-    float getOutputPeak(int channel) const;
+    // Forwarded to whichever precision chain is active
+    float getSaturationCurveValue(float input) const;
+    std::vector<float> getEqualizerFrequencyResponse() const;
+    std::vector<float> getEqualizerTargetCurve() const;
+    std::vector<float> getEqualizerSpectrum() const;
+    
+    // Automation granularity: while parameters move, continuous ones ramp from the
+    // previous block's values to the new ones in steps of this many samples (0 steps
+    // once per host block). Blocks without parameter changes are never split. The gain
+    // ramp length follows at the next prepareToPlay().
+    void setAutomationSubBlockSize(int numSamples);
+    int getAutomationSubBlockSize() const { return automationSubBlockSize; }
+    
+    // Opt-in: process channel pairs of surround layouts on a worker pool.
+    // Takes effect at the next prepareToPlay().
+    void setChannelParallelismEnabled(bool shouldBeEnabled) { channelParallelismEnabled = shouldBeEnabled; }
+    bool isChannelParallelismEnabled() const { return channelParallelismEnabled; }
+    
+    // Neural saturation model. Loading parses the file on the calling thread (never
+    // the audio thread); the audio thread picks the model up at its next block.
+    bool loadNeuralModel(const juce::File& file, juce::String& error);
+    juce::String getNeuralModelName() const;
+    
+    // Level monitoring (safe to read from any thread)
+    const MeterSnapshot& getMeterSnapshot() const { return meterSnapshot; }
+    
+    // Per-stage CPU profiling, published with the meter frame. Off unless a
+    // diagnostics view asks for it.
+    void setStageProfilingEnabled(bool shouldBeEnabled) { stageProfilingEnabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isStageProfilingEnabled() const { return stageProfilingEnabled.load(std::memory_order_relaxed); }
+    
+    // Real-time deadline statistics; misses and outliers are also appended to a log file
+    const DeadlineMonitor& getDeadlineMonitor() const { return deadlineMonitor; }
+    juce::File getDeadlineLogFile() const { return deadlineLog->getLogFile(); }
+    
+    // Heap memory held by this instance, per module. Reads what prepareToPlay() sized,
+    // so call it from the thread that prepares the plugin (normally the message thread).
+    MemoryFootprint getMemoryFootprint() const;
 
 private:
-    void updateParameters();
-    void updateProcessingChain();
+    // Modules that need reconfiguring, set from parameter listeners
+    enum DirtyFlags : uint32
+    {
+        gainsDirty      = 1 << 0,
+        saturationDirty = 1 << 1,
+        filtersDirty    = 1 << 2,
+        equalizerDirty  = 1 << 3,
+        allDirty        = gainsDirty | saturationDirty | filtersDirty | equalizerDirty
+    };
+    
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    
+    // Reports latency changes made on the audio thread to the host
+    void timerCallback() override;
+    static constexpr int latencyPollIntervalMs = 100;
+    static uint32 getDirtyFlagForParameter(const juce::String& parameterID);
+    
+    template <typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer, ProcessingChain<SampleType>& chain, bool bypassed);
+    
+    template <typename SampleType>
+    void warmUpChain(ProcessingChain<SampleType>& chain);
+    
+    // Reads changed parameters: switches apply at once, continuous values become the
+    // targets of the chain's automation ramp. Returns false if nothing changed.
+    template <typename SampleType>
+    bool updateParameters(ProcessingChain<SampleType>& chain);
+    
+    // Applies all changed parameters without ramping, for prepare and bypass release
+    template <typename SampleType>
+    void jumpToParameters(ProcessingChain<SampleType>& chain);
+    
+    // Passes the chain's latency to the bypass and, if it changed, to the host
+    template <typename SampleType>
+    void updateLatencyAndTail(ProcessingChain<SampleType>& chain);
+    
+    // Records each channel's last output sample as its rest level; returns true if the
+    // whole block sat at that level
+    template <typename SampleType>
+    bool captureRestOutput(const juce::dsp::AudioBlock<SampleType>& block);
+    
+    void applyNeuralModels();
+    
+    template <typename SampleType>
+    void publishMeters(ProcessingChain<SampleType>& chain, int numChannels);
+    
+    // The settings that affect CPU load, packed into a code on the audio thread (see
+    // DeadlineMonitor::setConfiguration) and turned into a one-line summary for the log
+    juce::uint64 packConfiguration() const noexcept;
+    juce::String describeConfiguration(juce::uint64 configuration) const;
     
     juce::AudioProcessorValueTreeState valueTreeState;
     
-    // DSP Chain
-    juce::dsp::Gain<float> inputGain;
-    LinearPhaseFilters preFilters;
-    SaturationProcessor saturationProcessor;
-    AdaptiveEqualizer adaptiveEqualizer;
-    LinearPhaseFilters postFilters;
-    juce::dsp::Gain<float> outputGain;
-    LoudnessCompensator loudnessCompensator;
+    // DSP chains; only the one matching the host's processing precision is prepared
+    ProcessingChain<float> floatChain;
+    ProcessingChain<double> doubleChain;
     
     // Parameter pointers for efficient access
     std::atomic<float>* inputGainParameter = nullptr;
@@ -75,6 +161,20 @@ private:
     std::atomic<float>* outputGainParameter = nullptr;
     std::atomic<float>* satTypeParameter = nullptr;
     std::atomic<float>* soloSaturationParameter = nullptr;
+    std::atomic<float>* tubeModelParameter = nullptr;
+    std::atomic<float>* tapeModelParameter = nullptr;
+    
+    // Mid/Side parameters
+    std::atomic<float>* stereoModeParameter = nullptr;
+    std::atomic<float>* sideDriveParameter = nullptr;
+    std::atomic<float>* sideSatTypeParameter = nullptr;
+    
+    // Multiband parameters
+    std::atomic<float>* numBandsParameter = nullptr;
+    std::array<std::atomic<float>*, ParameterIDs::maxBands - 1> crossoverFreqParameters {};
+    std::array<std::atomic<float>*, ParameterIDs::maxBands> bandDriveParameters {};
+    std::array<std::atomic<float>*, ParameterIDs::maxBands> bandSatTypeParameters {};
+    std::array<std::atomic<float>*, ParameterIDs::maxBands> bandMixParameters {};
     
     // Filter parameters
     std::atomic<float>* lowCutFreqParameter = nullptr;
@@ -87,18 +187,60 @@ private:
     std::atomic<float>* eqAdaptionStrengthParameter = nullptr;
     std::atomic<float>* eqReactionSpeedParameter = nullptr;
     
+    std::atomic<uint32> dirtyParameters { allDirty };
+    
     // Level monitoring
-    std::array<float, 2> inputRMSLevels = { 0.0f, 0.0f };
-    std::array<float, 2> inputPeakLevels = { 0.0f, 0.0f };
-    std::array<float, 2> outputRMSLevels = { 0.0f, 0.0f };
-    std::array<float, 2> outputPeakLevels = { 0.0f, 0.0f };
+    std::array<float, MeterFrame::maxChannels> inputRMSLevels {};
+    std::array<float, MeterFrame::maxChannels> inputPeakLevels {};
+    std::array<float, MeterFrame::maxChannels> outputRMSLevels {};
+    std::array<float, MeterFrame::maxChannels> outputPeakLevels {};
+    std::array<float, MeterFrame::maxChannels> outputTruePeakLevels {};
+    
+    MeterSnapshot meterSnapshot;
+    std::atomic<bool> stageProfilingEnabled { false };
+    
+    DeadlineMonitor deadlineMonitor;
+    std::unique_ptr<DeadlineLog> deadlineLog;
+    bool ownsTraceRecording = false;
+    
+    // Silence detection. Once the input has been digitally silent for longer than the
+    // chain's tail and the last block came out constant, stages 1-6 are skipped and the
+    // output holds that rest level. It is not always zero: Tube Warm, for one, leaves a
+    // DC offset. Any non-zero input counts, since the chain may add over 50 dB of gain.
+    static constexpr double restTolerance = 1.0e-7; // -140 dBFS, measured at the output
+    juce::int64 silentInputSamples = 0;
+    bool outputAtRest = false;
+    std::vector<double> restOutputLevels;
+    std::atomic<int> tailLengthSamples { 0 };
+    std::atomic<int> reportedLatencySamples { 0 };
+    
+    // Step size of the automation ramps within a host block
+    static constexpr int defaultAutomationSubBlockSize = 64;
+    int automationSubBlockSize = defaultAutomationSubBlockSize;
+    
+    // Neural models, one per precision, built together from one file
+    struct NeuralModels
+    {
+        std::unique_ptr<NeuralAmpModel<float>> floatModel;
+        std::unique_ptr<NeuralAmpModel<double>> doubleModel;
+    };
     
-    // Processing buffers
-    juce::AudioBuffer<float> dryBuffer;
-    juce::AudioBuffer<float> wetBuffer;
+    // Every published model stays alive until the audio thread has acknowledged a newer one
+    static inline const juce::Identifier neuralModelPathProperty { "neuralModelPath" };
+    juce::CriticalSection neuralModelLock; // serialises loads; never taken by the audio thread
+    std::vector<std::pair<uint32, std::unique_ptr<NeuralModels>>> neuralModelHistory;
+    std::atomic<NeuralModels*> publishedNeuralModels { nullptr };
+    std::atomic<uint32> neuralModelGeneration { 0 };
+    std::atomic<uint32> appliedNeuralModelGeneration { 0 };
+    juce::String neuralModelName;
     
-    // Smoothing for parameter changes
-    static constexpr float smoothingTimeSeconds = 0.05f;
+    // Channel-parallel processing
+    static constexpr size_t channelsPerLane = 2;
+    static constexpr int maxChannelWorkers = 3;
+    bool channelParallelismEnabled = false;
+    ChannelWorkerPool channelWorkers;
+    juce::CriticalSection audioWorkgroupLock; // host and message threads, never the audio thread
+    juce::AudioWorkgroup audioWorkgroup;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfessionalSaturationAudioProcessor)
 };
@@ -0,0 +1,174 @@
+#include "StateFormat.h"
+#include <unordered_map>
+
+namespace StateFormat
+{
+    namespace
+    {
+        constexpr int headerSize = 8;
+        constexpr int parameterEntrySize = 8;
+        
+        // Validates sizes before touching the data, so a truncated blob reads as invalid
+        bool readString(juce::MemoryInputStream& stream, const char* base, int length, juce::String& result)
+        {
+            if (length < 0 || stream.getNumBytesRemaining() < length)
+                return false;
+            
+            result = juce::String::fromUTF8(base + stream.getPosition(), length);
+            stream.skipNextBytes(length);
+            return true;
+        }
+    }
+    
+    juce::uint32 hashParameterID(const juce::String& parameterID) noexcept
+    {
+        // FNV-1a, fixed here because juce::String::hashCode() is not guaranteed stable across versions
+        juce::uint32 hash = 2166136261u;
+        
+        for (auto* character = parameterID.toRawUTF8(); *character != 0; ++character)
+        {
+            hash ^= static_cast<juce::uint8>(*character);
+            hash *= 16777619u;
+        }
+        
+        return hash;
+    }
+    
+    bool isBinaryState(const void* data, int sizeInBytes) noexcept
+    {
+        return data != nullptr && sizeInBytes >= headerSize
+            && juce::ByteOrder::littleEndianInt(data) == magic;
+    }
+    
+    void write(const juce::AudioProcessorValueTreeState& state, juce::MemoryBlock& destData)
+    {
+        const auto& parameters = state.processor.getParameters();
+        const auto& tree = state.state;
+        
+        destData.reset();
+        juce::MemoryOutputStream stream(destData, false);
+        
+        stream.writeInt(static_cast<int>(magic));
+        stream.writeShort(static_cast<short>(currentVersion));
+        
+        // Count first: the entry count precedes the entries
+        int numParameters = 0;
+        
+        for (auto* parameter : parameters)
+            if (dynamic_cast<juce::RangedAudioParameter*>(parameter) != nullptr)
+                ++numParameters;
+        
+        stream.writeShort(static_cast<short>(numParameters));
+        
+        for (auto* parameter : parameters)
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            {
+                stream.writeInt(static_cast<int>(hashParameterID(ranged->paramID)));
+                stream.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+            }
+        }
+        
+        int numProperties = 0;
+        
+        for (int index = 0; index < tree.getNumProperties(); ++index)
+            if (tree.getProperty(tree.getPropertyName(index)).isString())
+                ++numProperties;
+        
+        stream.writeShort(static_cast<short>(numProperties));
+        
+        for (int index = 0; index < tree.getNumProperties(); ++index)
+        {
+            const auto name = tree.getPropertyName(index);
+            const auto& value = tree.getProperty(name);
+            
+            if (! value.isString())
+                continue;
+            
+            const auto nameText = name.toString();
+            const auto valueText = value.toString();
+            
+            stream.writeShort(static_cast<short>(nameText.getNumBytesAsUTF8()));
+            stream.write(nameText.toRawUTF8(), nameText.getNumBytesAsUTF8());
+            stream.writeInt(static_cast<int>(valueText.getNumBytesAsUTF8()));
+            stream.write(valueText.toRawUTF8(), valueText.getNumBytesAsUTF8());
+        }
+    }
+    
+    bool read(juce::AudioProcessorValueTreeState& state, const void* data, int sizeInBytes)
+    {
+        if (! isBinaryState(data, sizeInBytes))
+            return false;
+        
+        const auto* base = static_cast<const char*>(data);
+        juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+        stream.skipNextBytes(4);
+        
+        const auto version = static_cast<juce::uint16>(stream.readShort());
+        const auto numParameters = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+        juce::ignoreUnused(version); // version 1 is the first; later ones only append
+        
+        if (stream.getNumBytesRemaining() < static_cast<juce::int64>(numParameters) * parameterEntrySize)
+            return false;
+        
+        std::unordered_map<juce::uint32, float> values;
+        values.reserve(static_cast<size_t>(numParameters));
+        
+        for (int entry = 0; entry < numParameters; ++entry)
+        {
+            const auto hash = static_cast<juce::uint32>(stream.readInt());
+            values[hash] = stream.readFloat();
+        }
+        
+        std::vector<std::pair<juce::Identifier, juce::String>> properties;
+        
+        if (stream.getNumBytesRemaining() >= 2)
+        {
+            const auto numProperties = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+            
+            for (int entry = 0; entry < numProperties; ++entry)
+            {
+                juce::String name, value;
+                
+                if (stream.getNumBytesRemaining() < 2
+                 || ! readString(stream, base, static_cast<juce::uint16>(stream.readShort()), name)
+                 || stream.getNumBytesRemaining() < 4
+                 || ! readString(stream, base, stream.readInt(), value)
+                 || name.isEmpty())
+                    return false;
+                
+                properties.emplace_back(name, value);
+            }
+        }
+        
+        // The same route the XML state takes through replaceState(): notify only on change
+        for (auto* parameter : state.processor.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            {
+                const auto found = values.find(hashParameterID(ranged->paramID));
+                const auto newValue = found != values.end() ? ranged->convertTo0to1(found->second) : ranged->getDefaultValue();
+                
+                if (ranged->getValue() != newValue)
+                    ranged->setValueNotifyingHost(newValue);
+            }
+        }
+        
+        // Properties absent from the blob are dropped, as a replaced tree would drop them
+        auto& tree = state.state;
+        
+        for (int index = tree.getNumProperties(); --index >= 0;)
+        {
+            const auto name = tree.getPropertyName(index);
+            
+            if (tree.getProperty(name).isString()
+             && std::none_of(properties.begin(), properties.end(), [&name](const auto& property) { return property.first == name; }))
+                tree.removeProperty(name, nullptr);
+        }
+        
+        for (const auto& [name, value] : properties)
+            tree.setProperty(name, value, nullptr);
+        
+        return true;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Compact binary plugin state, written and read without building a ValueTree or XML.
+//
+//   uint32  magic 'PSST'
+//   uint16  version
+//   uint16  parameter count, then per parameter:
+//           uint32 FNV-1a hash of the parameter ID, float32 plain (denormalised) value
+//   uint16  property count, then per top-level string property of the state tree:
+//           uint16 name length, UTF-8 name, uint32 value length, UTF-8 value
+//
+// All integers are little-endian. New versions only append sections, so a reader
+// takes what it knows from any version. Blobs without the magic are the XML state
+// of earlier releases and go through the old path.
+namespace StateFormat
+{
+    constexpr juce::uint32 magic = 0x54535350; // "PSST" in file order
+    constexpr juce::uint16 currentVersion = 1;
+    
+    juce::uint32 hashParameterID(const juce::String& parameterID) noexcept;
+    
+    bool isBinaryState(const void* data, int sizeInBytes) noexcept;
+    
+    void write(const juce::AudioProcessorValueTreeState& state, juce::MemoryBlock& destData);
+    
+    // Parameters missing from the blob return to their defaults, as with the XML state.
+    // Returns false, leaving the state untouched, if the blob is not a valid binary state.
+    bool read(juce::AudioProcessorValueTreeState& state, const void* data, int sizeInBytes);
+}
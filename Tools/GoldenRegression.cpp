@@ -0,0 +1,623 @@
+// Golden-output regression harness for SaturationProcessor.
+// Console app: links the same JUCE modules as the plugin and the DSP/ sources; the CMake
+// build (PSAT_BUILD_TOOLS) has a target of the same name.
+//
+// Renders fixed test signals through every saturation type/model, drive and
+// oversampling combination, plus multiband and mid/side processing for a few
+// types. The neural type needs a model (Tools/GoldenData has a small one) and is
+// skipped without --model. --record stores the output as the reference;
+// --compare renders again and null-tests against it within per-configuration
+// tolerances, also reporting THD and aliasing of the current and stored output.
+// Each comparison also nulls the float path against the double-precision path:
+//
+//   GoldenRegression --record refs/ [--model model.json]
+//   GoldenRegression --compare refs/ [--model model.json] [--tolerances file.json]
+//                    [--report results.json] [--filter "Tape"]
+//
+// Tolerances come from --tolerances or else refs/tolerances.json when present, e.g.
+//   { "default": { "nullDb": -90, "metricDb": 0.5, "precisionDb": -60 }, "Hysteresis": { "nullDb": -70 } }
+// The longest key contained in a configuration's name wins.
+//
+// The CMake build registers a CTest test that records references with this harness
+// built against the DSP/ sources of the golden-baseline tag on main, then compares.
+
+#include <JuceHeader.h>
+#include "../DSP/SaturationProcessor.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr float drives[] = { 0.0f, 12.0f, 24.0f };
+    constexpr int oversamplingOrders[] = { 0, 2, 4 };
+    constexpr double defaultNullToleranceDb = -90.0;
+    constexpr double defaultMetricToleranceDb = 0.5;
+    constexpr double defaultPrecisionToleranceDb = -60.0;
+
+    // Measurement tones for THD and aliasing, off any FFT bin centre
+    constexpr double thdFrequency = 997.0;
+    constexpr double aliasingFrequency = 7919.0;
+
+    struct TestSignal
+    {
+        const char* name;
+        int numSamples;
+    };
+
+    const TestSignal testSignals[] = {
+        { "sweep", 96000 }, { "multitone", 24000 }, { "impulses", 24000 },
+        { "noise", 24000 }, { "thdTone", 32768 }, { "aliasTone", 32768 }
+    };
+
+    struct Configuration
+    {
+        int type = 0;
+        int tubeModel = SaturationProcessor<float>::TubeClassic;
+        int tapeModel = SaturationProcessor<float>::TapeClassic;
+        float drive = 0.0f;
+        int oversamplingOrder = SaturationProcessor<float>::defaultOversamplingOrder;
+        int numBands = 1;
+        int stereoMode = SaturationProcessor<float>::LeftRight;
+
+        // Mid/side needs a stereo signal; everything else is rendered in mono
+        int getNumChannels() const { return stereoMode == SaturationProcessor<float>::MidSide ? 2 : 1; }
+
+        juce::String getName() const
+        {
+            const char* typeNames[] = { "Tube Warm", "Tape Classic", "Transistor Modern", "Diode Harsh", "Vintage Fuzz", "Neural Model" };
+            const char* tubeNames[] = { "", " (WDF)" };
+            const char* tapeNames[] = { "", " (Hysteresis RK2)", " (Hysteresis RK4)" };
+
+            return juce::String(typeNames[type]) + (type == 0 ? tubeNames[tubeModel] : "") + (type == 1 ? tapeNames[tapeModel] : "")
+                 + (numBands > 1 ? ", " + juce::String(numBands) + " bands" : juce::String())
+                 + (getNumChannels() > 1 ? ", M-S" : "")
+                 + ", " + juce::String(drive, 0) + " dB, " + juce::String(1 << oversamplingOrder) + "x";
+        }
+
+        juce::String getFileName() const
+        {
+            return juce::File::createLegalFileName(getName().replace(", ", "_").replace(" ", "-")) + ".wav";
+        }
+    };
+
+    struct Metrics
+    {
+        double thdDb = 0.0;
+        double aliasingDb = 0.0;
+    };
+
+    struct Tolerance
+    {
+        double nullDb = defaultNullToleranceDb;
+        double metricDb = defaultMetricToleranceDb;
+        double precisionDb = defaultPrecisionToleranceDb;
+    };
+
+    // The test model for the neural type, one per precision; null when none was given
+    struct NeuralModels
+    {
+        std::unique_ptr<NeuralAmpModel<float>> floatModel;
+        std::unique_ptr<NeuralAmpModel<double>> doubleModel;
+    };
+
+    NeuralModels neuralModels;
+
+    template <typename SampleType>
+    const NeuralAmpModel<SampleType>* getNeuralModel()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return neuralModels.floatModel.get();
+        else
+            return neuralModels.doubleModel.get();
+    }
+
+    std::vector<Configuration> makeConfigurations(bool withNeuralModel)
+    {
+        std::vector<Configuration> configurations;
+        const auto numTypes = withNeuralModel ? SaturationProcessor<float>::neuralModelType + 1 : SaturationProcessor<float>::neuralModelType;
+
+        for (int type = 0; type < numTypes; ++type)
+        {
+            const auto numModels = type == 0 ? 2 : (type == 1 ? 3 : 1);
+
+            for (int model = 0; model < numModels; ++model)
+                for (const auto drive : drives)
+                    for (const auto order : oversamplingOrders)
+                    {
+                        Configuration configuration;
+                        configuration.type = type;
+                        configuration.tubeModel = type == 0 ? model : 0;
+                        configuration.tapeModel = type == 1 ? model : 0;
+                        configuration.drive = drive;
+                        configuration.oversamplingOrder = order;
+                        configurations.push_back(configuration);
+                    }
+        }
+
+        // Band splitting and mid/side at one drive, with the default oversampling
+        for (const auto type : { 0, 1, 4 })
+        {
+            for (const auto [numBands, stereoMode] : { std::pair(3, 0), std::pair(1, 1), std::pair(3, 1) })
+            {
+                Configuration configuration;
+                configuration.type = type;
+                configuration.drive = 12.0f;
+                configuration.numBands = numBands;
+                configuration.stereoMode = stereoMode;
+                configurations.push_back(configuration);
+            }
+        }
+
+        return configurations;
+    }
+
+    // Deterministic test signals; every run and machine produces the same input
+    void generateSignal(int index, float* data)
+    {
+        const auto& signal = testSignals[index];
+        const auto twoPi = juce::MathConstants<double>::twoPi;
+        juce::Random random(42);
+
+        for (int sample = 0; sample < signal.numSamples; ++sample)
+        {
+            const auto time = sample / sampleRate;
+            double value = 0.0;
+
+            switch (index)
+            {
+                case 0:
+                {
+                    // Exponential sweep 20 Hz - 20 kHz
+                    const auto duration = signal.numSamples / sampleRate;
+                    const auto rate = std::log(20000.0 / 20.0);
+                    value = 0.5 * std::sin(twoPi * 20.0 * duration / rate * (std::exp(time * rate / duration) - 1.0));
+                    break;
+                }
+                case 1:
+                    for (const auto frequency : { 63.0, 251.0, 1009.0, 3989.0, 11003.0 })
+                        value += 0.12 * std::sin(twoPi * frequency * time);
+                    break;
+                case 2:
+                    value = sample % 4800 == 0 ? 0.9 : 0.0;
+                    break;
+                case 3:
+                    value = 0.5 * (random.nextDouble() * 2.0 - 1.0);
+                    break;
+                case 4:
+                    value = 0.5 * std::sin(twoPi * thdFrequency * time);
+                    break;
+                default:
+                    value = 0.5 * std::sin(twoPi * aliasingFrequency * time);
+                    break;
+            }
+
+            data[sample] = static_cast<float>(value);
+        }
+    }
+
+    int getTotalSignalLength()
+    {
+        int total = 0;
+
+        for (const auto& signal : testSignals)
+            total += signal.numSamples;
+
+        return total;
+    }
+
+    // All test signals rendered back to back into one buffer, each from a fresh processor.
+    // A second channel carries the signal delayed and scaled, so the side is not silent.
+    template <typename SampleType>
+    juce::AudioBuffer<float> render(const Configuration& configuration)
+    {
+        constexpr int rightDelay = 5;
+        constexpr float rightGain = 0.7f;
+
+        const auto numChannels = configuration.getNumChannels();
+        juce::AudioBuffer<float> output(numChannels, getTotalSignalLength());
+        std::vector<std::vector<SampleType>> signals(static_cast<size_t>(numChannels));
+        int offset = 0;
+
+        for (int index = 0; index < static_cast<int>(std::size(testSignals)); ++index)
+        {
+            SaturationProcessor<SampleType> saturation;
+            saturation.setOversamplingOrder(configuration.oversamplingOrder);
+            saturation.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) });
+            saturation.setSaturationType(configuration.type);
+            saturation.setTubeModel(configuration.tubeModel);
+            saturation.setTapeModel(configuration.tapeModel);
+            saturation.setNeuralModel(getNeuralModel<SampleType>());
+            saturation.setDrive(configuration.drive);
+            saturation.setMix(100.0f);
+            saturation.setStereoMode(configuration.stereoMode);
+            saturation.setSideDrive(configuration.drive - 6.0f);
+            saturation.setSideSaturationType(configuration.type);
+            saturation.setNumBands(configuration.numBands);
+
+            // Bands share the type but not the drive, so each band's path is distinguishable
+            for (int band = 0; band < configuration.numBands; ++band)
+            {
+                saturation.setBandSaturationType(band, configuration.type);
+                saturation.setBandDrive(band, configuration.drive + 6.0f * static_cast<float>(band - 1));
+                saturation.setBandMix(band, 100.0f);
+            }
+
+            // Drive and mix smoothing start from the target
+            saturation.reset();
+
+            const auto numSamples = testSignals[index].numSamples;
+            auto* left = output.getWritePointer(0, offset);
+            generateSignal(index, left);
+
+            if (numChannels > 1)
+            {
+                auto* right = output.getWritePointer(1, offset);
+
+                for (int sample = 0; sample < numSamples; ++sample)
+                    right[sample] = sample >= rightDelay ? rightGain * left[sample - rightDelay] : 0.0f;
+            }
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const auto* data = output.getReadPointer(channel, offset);
+                signals[static_cast<size_t>(channel)].assign(data, data + numSamples);
+            }
+
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                SampleType* channels[2] = {};
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    channels[channel] = signals[static_cast<size_t>(channel)].data() + start;
+
+                juce::dsp::AudioBlock<SampleType> block(channels, static_cast<size_t>(numChannels),
+                                                        static_cast<size_t>(juce::jmin(blockSize, numSamples - start)));
+                saturation.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+            }
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const auto& signal = signals[static_cast<size_t>(channel)];
+                std::transform(signal.begin(), signal.end(), output.getWritePointer(channel, offset),
+                               [](SampleType sample) { return static_cast<float>(sample); });
+            }
+
+            offset += numSamples;
+        }
+
+        return output;
+    }
+
+    const float* findSignal(const juce::AudioBuffer<float>& buffer, int signalIndex, int channel = 0)
+    {
+        int offset = 0;
+
+        for (int index = 0; index < signalIndex; ++index)
+            offset += testSignals[index].numSamples;
+
+        return buffer.getReadPointer(channel, offset);
+    }
+
+    // Harmonic distortion and everything that is neither fundamental nor harmonic,
+    // both relative to the fundamental, from the steady second half of a tone
+    double measureTone(const float* data, int numSamples, double frequency, bool harmonicsOnly)
+    {
+        constexpr int fftOrder = 14;
+        constexpr int fftSize = 1 << fftOrder;
+        constexpr int binRadius = 4;
+
+        juce::dsp::FFT fft(fftOrder);
+        juce::dsp::WindowingFunction<float> window(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris, false);
+        std::vector<float> spectrum(2 * fftSize, 0.0f);
+
+        std::copy(data + numSamples - fftSize, data + numSamples, spectrum.begin());
+        window.multiplyWithWindowingTable(spectrum.data(), fftSize);
+        fft.performFrequencyOnlyForwardTransform(spectrum.data());
+
+        const auto binWidth = sampleRate / fftSize;
+        const auto numBins = fftSize / 2;
+        std::vector<bool> claimed(static_cast<size_t>(numBins), false);
+
+        const auto bandPower = [&](double centre)
+        {
+            const auto centreBin = juce::roundToInt(centre / binWidth);
+            double power = 0.0;
+
+            for (int bin = juce::jmax(1, centreBin - binRadius); bin <= juce::jmin(numBins - 1, centreBin + binRadius); ++bin)
+            {
+                power += static_cast<double>(spectrum[static_cast<size_t>(bin)]) * spectrum[static_cast<size_t>(bin)];
+                claimed[static_cast<size_t>(bin)] = true;
+            }
+
+            return power;
+        };
+
+        const auto fundamental = bandPower(frequency);
+        double harmonics = 0.0;
+
+        for (int harmonic = 2; harmonic * frequency < sampleRate / 2.0 - binRadius * binWidth; ++harmonic)
+            harmonics += bandPower(harmonic * frequency);
+
+        double other = 0.0;
+
+        // DC and the first bins carry window leakage from any offset, not aliasing
+        for (int bin = binRadius + 1; bin < numBins; ++bin)
+            if (! claimed[static_cast<size_t>(bin)])
+                other += static_cast<double>(spectrum[static_cast<size_t>(bin)]) * spectrum[static_cast<size_t>(bin)];
+
+        const auto ratio = (harmonicsOnly ? harmonics : other) / juce::jmax(fundamental, 1.0e-30);
+        return 10.0 * std::log10(juce::jmax(ratio, 1.0e-30));
+    }
+
+    Metrics measure(const juce::AudioBuffer<float>& output)
+    {
+        return { measureTone(findSignal(output, 4), testSignals[4].numSamples, thdFrequency, true),
+                 measureTone(findSignal(output, 5), testSignals[5].numSamples, aliasingFrequency, false) };
+    }
+
+    // Residual energy after subtracting the reference, relative to the reference
+    double nullResidualDb(const float* current, const float* reference, int numSamples)
+    {
+        double residual = 0.0, energy = 0.0;
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const auto difference = static_cast<double>(current[sample]) - reference[sample];
+            residual += difference * difference;
+            energy += static_cast<double>(reference[sample]) * reference[sample];
+        }
+
+        if (residual == 0.0)
+            return -400.0;
+
+        return 10.0 * std::log10(residual / juce::jmax(energy, 1.0e-30));
+    }
+
+    bool writeReference(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+
+        if (stream == nullptr)
+            return false;
+
+        // 32-bit float keeps the reference bit-exact
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(buffer.getNumChannels()), 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    bool readReference(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr || reader->lengthInSamples != buffer.getNumSamples()
+            || static_cast<int>(reader->numChannels) != buffer.getNumChannels())
+            return false;
+
+        return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, false);
+    }
+
+    Tolerance findTolerance(const juce::var& tolerances, const juce::String& name)
+    {
+        Tolerance tolerance;
+        juce::String bestKey;
+
+        const auto apply = [&tolerance](const juce::var& entry)
+        {
+            tolerance.nullDb = entry.getProperty("nullDb", tolerance.nullDb);
+            tolerance.metricDb = entry.getProperty("metricDb", tolerance.metricDb);
+            tolerance.precisionDb = entry.getProperty("precisionDb", tolerance.precisionDb);
+        };
+
+        if (auto* object = tolerances.getDynamicObject())
+        {
+            apply(tolerances["default"]);
+
+            for (const auto& property : object->getProperties())
+            {
+                const auto key = property.name.toString();
+
+                if (key != "default" && name.contains(key) && key.length() > bestKey.length())
+                    bestKey = key;
+            }
+
+            if (bestKey.isNotEmpty())
+                apply(tolerances[juce::Identifier(bestKey)]);
+        }
+
+        return tolerance;
+    }
+
+    juce::var metricsToVar(const Metrics& metrics)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("thdDb", metrics.thdDb);
+        object->setProperty("aliasingDb", metrics.aliasingDb);
+        return juce::var(object);
+    }
+
+    int record(const juce::File& directory, const std::vector<Configuration>& configurations)
+    {
+        if (! directory.createDirectory())
+        {
+            std::fprintf(stderr, "Cannot create %s\n", directory.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        auto* manifest = new juce::DynamicObject();
+        manifest->setProperty("sampleRate", sampleRate);
+
+        for (const auto& configuration : configurations)
+        {
+            const auto output = render<float>(configuration);
+            const auto metrics = measure(output);
+
+            if (! writeReference(directory.getChildFile(configuration.getFileName()), output))
+            {
+                std::fprintf(stderr, "Cannot write reference for %s\n", configuration.getName().toRawUTF8());
+                return 1;
+            }
+
+            manifest->setProperty(configuration.getName(), metricsToVar(metrics));
+            std::printf("recorded %-48s THD %7.1f dB  aliasing %7.1f dB\n", configuration.getName().toRawUTF8(), metrics.thdDb, metrics.aliasingDb);
+        }
+
+        directory.getChildFile("reference.json").replaceWithText(juce::JSON::toString(juce::var(manifest)));
+        return 0;
+    }
+
+    int compare(const juce::File& directory, const std::vector<Configuration>& configurations,
+                const juce::File& toleranceFile, const juce::File& reportFile)
+    {
+        const auto manifest = juce::JSON::parse(directory.getChildFile("reference.json"));
+        const auto tolerances = juce::JSON::parse(toleranceFile);
+
+        if (! manifest.isObject())
+        {
+            std::fprintf(stderr, "No reference.json in %s; run --record first\n", directory.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        juce::Array<juce::var> results;
+        int failures = 0;
+
+        std::printf("%-48s %10s %10s %10s %10s %10s  %s\n", "configuration", "null dB", "limit dB", "f/d dB", "THD dB", "alias dB", "result");
+
+        for (const auto& configuration : configurations)
+        {
+            const auto name = configuration.getName();
+            const auto tolerance = findTolerance(tolerances, name);
+            const auto current = render<float>(configuration);
+            const auto metrics = measure(current);
+
+            juce::AudioBuffer<float> reference(current.getNumChannels(), current.getNumSamples());
+            const auto stored = manifest[juce::Identifier(name)];
+
+            if (! stored.isObject() || ! readReference(directory.getChildFile(configuration.getFileName()), reference))
+            {
+                std::printf("%-48s missing reference\n", name.toRawUTF8());
+                ++failures;
+                continue;
+            }
+
+            // The float path must also agree with the double-precision path it approximates
+            const auto precise = render<double>(configuration);
+
+            // The worst signal and channel decide
+            double worstNull = -400.0, worstPrecision = -400.0;
+            auto* signalResults = new juce::DynamicObject();
+
+            for (int index = 0; index < static_cast<int>(std::size(testSignals)); ++index)
+            {
+                const auto numSamples = testSignals[index].numSamples;
+                double residual = -400.0;
+
+                for (int channel = 0; channel < current.getNumChannels(); ++channel)
+                {
+                    residual = juce::jmax(residual, nullResidualDb(findSignal(current, index, channel), findSignal(reference, index, channel), numSamples));
+                    worstPrecision = juce::jmax(worstPrecision, nullResidualDb(findSignal(current, index, channel), findSignal(precise, index, channel), numSamples));
+                }
+
+                signalResults->setProperty(testSignals[index].name, residual);
+                worstNull = juce::jmax(worstNull, residual);
+            }
+
+            const Metrics referenceMetrics { stored["thdDb"], stored["aliasingDb"] };
+            const bool nullPassed = worstNull <= tolerance.nullDb;
+            const bool precisionPassed = worstPrecision <= tolerance.precisionDb;
+            const bool metricsPassed = std::abs(metrics.thdDb - referenceMetrics.thdDb) <= tolerance.metricDb
+                                    && std::abs(metrics.aliasingDb - referenceMetrics.aliasingDb) <= tolerance.metricDb;
+            const bool passed = nullPassed && precisionPassed && metricsPassed;
+            failures += passed ? 0 : 1;
+
+            const char* result = passed ? "pass" : (! nullPassed ? "FAIL (null)" : (! precisionPassed ? "FAIL (precision)" : "FAIL (metrics)"));
+            std::printf("%-48s %10.1f %10.1f %10.1f %10.1f %10.1f  %s\n", name.toRawUTF8(), worstNull, tolerance.nullDb,
+                        worstPrecision, metrics.thdDb, metrics.aliasingDb, result);
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("configuration", name);
+            entry->setProperty("passed", passed);
+            entry->setProperty("nullResidualDb", signalResults);
+            entry->setProperty("nullToleranceDb", tolerance.nullDb);
+            entry->setProperty("metricToleranceDb", tolerance.metricDb);
+            entry->setProperty("precisionResidualDb", worstPrecision);
+            entry->setProperty("precisionToleranceDb", tolerance.precisionDb);
+            entry->setProperty("current", metricsToVar(metrics));
+            entry->setProperty("reference", metricsToVar(referenceMetrics));
+            results.add(juce::var(entry));
+        }
+
+        std::printf("%d of %d configurations passed\n", static_cast<int>(configurations.size()) - failures, static_cast<int>(configurations.size()));
+
+        if (reportFile != juce::File())
+        {
+            auto* report = new juce::DynamicObject();
+            report->setProperty("failures", failures);
+            report->setProperty("results", results);
+            reportFile.replaceWithText(juce::JSON::toString(juce::var(report)));
+        }
+
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    const juce::ArgumentList arguments(argc, argv);
+    const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+    if (arguments.containsOption("--model"))
+    {
+        const auto modelFile = workingDirectory.getChildFile(arguments.getValueForOption("--model"));
+        juce::String error;
+        neuralModels.floatModel = NeuralAmpModel<float>::loadFromFile(modelFile, error);
+        neuralModels.doubleModel = NeuralAmpModel<double>::loadFromFile(modelFile, error);
+
+        if (neuralModels.floatModel == nullptr || neuralModels.doubleModel == nullptr)
+        {
+            std::fprintf(stderr, "Cannot load %s: %s\n", modelFile.getFullPathName().toRawUTF8(), error.toRawUTF8());
+            return 1;
+        }
+    }
+    else
+    {
+        std::printf("No --model given; the Neural Model configurations are skipped\n");
+    }
+
+    auto configurations = makeConfigurations(neuralModels.floatModel != nullptr);
+
+    if (arguments.containsOption("--filter"))
+    {
+        const auto filter = arguments.getValueForOption("--filter");
+        configurations.erase(std::remove_if(configurations.begin(), configurations.end(),
+                                            [&filter](const Configuration& c) { return ! c.getName().containsIgnoreCase(filter); }),
+                             configurations.end());
+    }
+
+    if (arguments.containsOption("--record"))
+        return record(workingDirectory.getChildFile(arguments.getValueForOption("--record")), configurations);
+
+    if (arguments.containsOption("--compare"))
+    {
+        const auto directory = workingDirectory.getChildFile(arguments.getValueForOption("--compare"));
+        const auto toleranceFile = arguments.containsOption("--tolerances") ? workingDirectory.getChildFile(arguments.getValueForOption("--tolerances"))
+                                                                            : directory.getChildFile("tolerances.json");
+        const auto reportFile = arguments.containsOption("--report") ? workingDirectory.getChildFile(arguments.getValueForOption("--report"))
+                                                                     : juce::File();
+        return compare(directory, configurations, toleranceFile, reportFile);
+    }
+
+    std::fprintf(stderr, "usage: GoldenRegression --record <dir> | --compare <dir> [--model <file>] [--tolerances <file>]"
+                         " [--report <file>] [--filter <text>]\n");
+    return 1;
+}
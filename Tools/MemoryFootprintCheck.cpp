@@ -0,0 +1,125 @@
+// Memory footprint check: builds and prepares one plugin instance in the default
+// configuration and measures the heap it really allocates, through the allocation
+// hooks of DSP/RealtimeSafety. Fails if that exceeds the budget, or if preparing again
+// with the same settings keeps more memory. The per-module figures the processor
+// reports are printed alongside, with whatever they do not account for.
+// Console app: build with the plugin sources (PluginProcessor, PluginEditor,
+// Components/, DSP/, LookAndFeel/, StateFormat), the same JUCE modules and JucePlugin_* defines,
+// plus PSAT_REALTIME_SAFETY_CHECKS=1; the CMake build does this and registers it with CTest.
+// It exits non-zero when a change makes instances heavier than the budget, or adds
+// allocations the modules do not report, so raising either is a deliberate decision.
+// The byte count comes from the operator new/delete hooks everywhere and, on Linux only,
+// from the malloc family too; elsewhere JUCE's malloc-based buffers (HeapBlock, and with
+// it AudioBuffer) are not counted, so the figure undercounts there.
+//
+//   MemoryFootprintCheck [--max-bytes 786432] [--max-unaccounted-bytes 262144]
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#if ! PSAT_REALTIME_SAFETY_CHECKS
+ #error "MemoryFootprintCheck must be built with PSAT_REALTIME_SAFETY_CHECKS=1"
+#endif
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int maxBlockSize = 512;
+
+    // Stereo, float, 48 kHz / 512: the modules report about 0.3 MB, most of it the 16x
+    // oversampler buffers, the bypass delay lines and the spectrum analysers. What they
+    // do not report (the parameter tree, JUCE objects, the worker threads and the first
+    // instance's share of process-wide tables) has its own, smaller allowance, so growth
+    // in either part fails rather than hiding in a shared margin.
+    constexpr size_t defaultBudgetBytes = 768 * 1024;
+    constexpr size_t defaultUnaccountedBudgetBytes = 256 * 1024;
+
+    // Allocator rounding and lazily grown JUCE internals may move a re-prepare slightly
+    constexpr juce::int64 reprepareSlackBytes = 16 * 1024;
+
+    void prepare(ProfessionalSaturationAudioProcessor& processor)
+    {
+        processor.setProcessingPrecision(juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList arguments(argc, argv);
+    const auto getBytesOption = [&arguments](const juce::String& option, size_t defaultBytes)
+    {
+        return arguments.containsOption(option)
+                   ? static_cast<size_t>(juce::jmax(juce::int64(0), arguments.getValueForOption(option).getLargeIntValue()))
+                   : defaultBytes;
+    };
+
+    const auto budget = getBytesOption("--max-bytes", defaultBudgetBytes);
+    const auto unaccountedBudget = getBytesOption("--max-unaccounted-bytes", defaultUnaccountedBudgetBytes);
+
+    std::unique_ptr<ProfessionalSaturationAudioProcessor> processor;
+    juce::int64 allocatedBytes = 0;
+
+    {
+        const RealtimeSafety::ScopedAllocationCounter counter;
+        processor = std::make_unique<ProfessionalSaturationAudioProcessor>();
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::stereo());
+        layout.outputBuses.add(juce::AudioChannelSet::stereo());
+        processor->setBusesLayout(layout);
+
+        prepare(*processor);
+        allocatedBytes = counter.getNetBytes();
+    }
+
+    const auto footprint = processor->getMemoryFootprint();
+    const auto allocated = static_cast<size_t>(juce::jmax(juce::int64(0), allocatedBytes));
+    const auto unaccounted = allocated > footprint.getTotalBytes() ? allocated - footprint.getTotalBytes() : size_t(0);
+
+    std::printf("Stereo, float, %.0f Hz, %d samples\n\n%s\n", sampleRate, maxBlockSize, footprint.toString().toRawUTF8());
+    std::printf("Allocated by construction and prepareToPlay(): %s (%s not reported by the modules)\n",
+                MemoryFootprint::formatBytes(allocated).toRawUTF8(), MemoryFootprint::formatBytes(unaccounted).toRawUTF8());
+
+    // Hosts re-prepare freely; the same settings must not keep more memory each time
+    juce::int64 reprepareBytes = 0;
+
+    {
+        const RealtimeSafety::ScopedAllocationCounter counter;
+        prepare(*processor);
+        reprepareBytes = counter.getNetBytes();
+    }
+
+    processor->releaseResources();
+
+    if (reprepareBytes > reprepareSlackBytes)
+    {
+        std::fprintf(stderr, "Preparing again with the same settings kept another %s\n",
+                     MemoryFootprint::formatBytes(static_cast<size_t>(reprepareBytes)).toRawUTF8());
+        return 1;
+    }
+
+    if (allocated > budget)
+    {
+        std::fprintf(stderr, "Footprint %s exceeds the budget of %s\n",
+                     MemoryFootprint::formatBytes(allocated).toRawUTF8(),
+                     MemoryFootprint::formatBytes(budget).toRawUTF8());
+        return 1;
+    }
+
+    // Memory the modules do not report is invisible in the breakdown, so it is bounded on its own
+    if (unaccounted > unaccountedBudget)
+    {
+        std::fprintf(stderr, "%s allocated outside the modules' reports exceeds the allowance of %s\n",
+                     MemoryFootprint::formatBytes(unaccounted).toRawUTF8(),
+                     MemoryFootprint::formatBytes(unaccountedBudget).toRawUTF8());
+        return 1;
+    }
+
+    std::printf("Within the budget of %s (%s outside the modules' reports)\n", MemoryFootprint::formatBytes(budget).toRawUTF8(),
+                MemoryFootprint::formatBytes(unaccountedBudget).toRawUTF8());
+    return 0;
+}
@@ -0,0 +1,306 @@
+// Offline batch render: streams audio files through the full plugin processor
+// and writes the results, several files at a time.
+// Console app: build with the plugin sources (PluginProcessor, PluginEditor,
+// Components/, DSP/, LookAndFeel/, StateFormat), the same JUCE modules and JucePlugin_* defines;
+// the CMake build (PSAT_BUILD_TOOLS) has a target of the same name.
+//
+//   OfflineRender --output-dir out [--state session.bin | --preset preset.xml]
+//                 [--threads N] [--block-size 4096] [--format wav|aiff|flac]
+//                 [--suffix _sat] [--no-tail] input files or folders...
+//
+// Outputs are aligned with their inputs: the plugin's reported latency is trimmed
+// from the start and rendered on at the end, before any tail.
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+namespace
+{
+    struct Options
+    {
+        juce::Array<juce::File> inputs;
+        juce::File outputDirectory;
+        juce::MemoryBlock state;
+        juce::String format = "wav";
+        juce::String suffix;
+        int numThreads = juce::jmax(1, juce::SystemStats::getNumCpus());
+        int blockSize = 4096;
+        bool renderTail = true;
+    };
+
+    // A state file is either the plugin's binary blob or a preset saved as XML
+    bool loadState(const juce::File& file, juce::MemoryBlock& state, juce::String& error)
+    {
+        if (! file.loadFileAsData(state))
+        {
+            error = "Cannot read state " + file.getFullPathName();
+            return false;
+        }
+
+        if (auto xml = juce::parseXML(file))
+        {
+            state.reset();
+            juce::AudioProcessor::copyXmlToBinary(*xml, state);
+        }
+
+        return true;
+    }
+
+    void collectInputs(const juce::File& fileOrFolder, const juce::AudioFormatManager& formats, juce::Array<juce::File>& inputs)
+    {
+        if (fileOrFolder.isDirectory())
+        {
+            for (const auto& entry : juce::RangedDirectoryIterator(fileOrFolder, false, formats.getWildcardForAllFormats()))
+                inputs.add(entry.getFile());
+        }
+        else if (fileOrFolder.existsAsFile())
+        {
+            inputs.add(fileOrFolder);
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormat> createOutputFormat(const juce::String& name)
+    {
+        if (name == "aiff")
+            return std::make_unique<juce::AiffAudioFormat>();
+
+        if (name == "flac")
+            return std::make_unique<juce::FlacAudioFormat>();
+
+        return std::make_unique<juce::WavAudioFormat>();
+    }
+
+    // Owns one processor and renders whole files with it, one after another
+    class RenderWorker : public juce::Thread
+    {
+    public:
+        RenderWorker(const Options& optionsToUse, std::atomic<int>& nextInputToUse, int index)
+            : juce::Thread("Render worker " + juce::String(index)),
+              options(optionsToUse), nextInput(nextInputToUse)
+        {
+            formats.registerBasicFormats();
+            processor = std::make_unique<ProfessionalSaturationAudioProcessor>();
+
+            if (options.state.getSize() > 0)
+                processor->setStateInformation(options.state.getData(), static_cast<int>(options.state.getSize()));
+
+            processor->setNonRealtime(true);
+        }
+
+        void run() override
+        {
+            for (;;)
+            {
+                const auto index = nextInput.fetch_add(1);
+
+                if (index >= options.inputs.size() || threadShouldExit())
+                    return;
+
+                juce::String message;
+                const auto input = options.inputs[index];
+                const auto ok = render(input, message);
+
+                const juce::ScopedLock lock(outputLock);
+                std::printf("%s %s: %s\n", ok ? "ok  " : "FAIL", input.getFileName().toRawUTF8(), message.toRawUTF8());
+                failures += ok ? 0 : 1;
+            }
+        }
+
+        int getNumFailures() const { return failures; }
+
+    private:
+        bool render(const juce::File& input, juce::String& message)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+
+            if (reader == nullptr)
+            {
+                message = "unsupported or unreadable file";
+                return false;
+            }
+
+            const auto numChannels = static_cast<int>(reader->numChannels);
+            const auto sampleRate = reader->sampleRate;
+
+            // The processor supports mono, stereo and the surround layouts it declares
+            const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(channelSet);
+            layout.outputBuses.add(channelSet);
+
+            if (channelSet.isDisabled() || ! processor->setBusesLayout(layout))
+            {
+                message = juce::String(numChannels) + " channels are not supported";
+                return false;
+            }
+
+            auto format = createOutputFormat(options.format);
+            const auto output = options.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + options.suffix)
+                                                       .withFileExtension(format->getFileExtensions()[0]);
+            output.deleteFile();
+
+            std::unique_ptr<juce::OutputStream> stream(output.createOutputStream());
+            const auto bitDepth = format->getPossibleBitDepths().contains(24) ? 24 : format->getPossibleBitDepths().getLast();
+            std::unique_ptr<juce::AudioFormatWriter> writer(stream != nullptr
+                ? format->createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels), bitDepth, {}, 0)
+                : nullptr);
+
+            if (writer == nullptr)
+            {
+                message = "cannot write " + output.getFullPathName();
+                return false;
+            }
+
+            stream.release(); // owned by the writer now
+
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+
+            processor->setRateAndBufferSizeDetails(sampleRate, options.blockSize);
+            processor->prepareToPlay(sampleRate, options.blockSize);
+
+            // Run the tail out after the file ends so reverb-like decays are not cut
+            const auto tailSamples = options.renderTail ? static_cast<juce::int64>(std::ceil(processor->getTailLengthSeconds() * sampleRate)) : 0;
+            const auto outputSamples = reader->lengthInSamples + tailSamples;
+
+            // The output lines up with the input: the chain's latency is rendered on top and dropped from the start
+            const auto latencySamples = static_cast<juce::int64>(processor->getLatencySamples());
+            const auto totalSamples = outputSamples + latencySamples;
+
+            juce::AudioBuffer<float> buffer(numChannels, options.blockSize);
+            juce::MidiBuffer midi;
+
+            for (juce::int64 position = 0; position < totalSamples; position += options.blockSize)
+            {
+                const auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(options.blockSize), totalSamples - position));
+                buffer.setSize(numChannels, numSamples, false, false, true);
+
+                // Reads past the end of the file fill with silence
+                reader->read(&buffer, 0, numSamples, position, true, true);
+                processor->processBlock(buffer, midi);
+
+                const auto skip = static_cast<int>(juce::jlimit(juce::int64(0), static_cast<juce::int64>(numSamples), latencySamples - position));
+
+                if (skip < numSamples && ! writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip))
+                {
+                    message = "write failed for " + output.getFullPathName();
+                    return false;
+                }
+            }
+
+            processor->releaseResources();
+
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            const auto audioSeconds = static_cast<double>(outputSamples) / sampleRate;
+            message = output.getFileName() + juce::String::formatted(" (%.1f s audio, %.1fx realtime)",
+                                                                     audioSeconds, seconds > 0.0 ? audioSeconds / seconds : 0.0);
+            return true;
+        }
+
+        const Options& options;
+        std::atomic<int>& nextInput;
+        juce::AudioFormatManager formats;
+        std::unique_ptr<ProfessionalSaturationAudioProcessor> processor;
+        int failures = 0;
+
+        static inline juce::CriticalSection outputLock;
+    };
+
+    bool parseOptions(const juce::ArgumentList& arguments, Options& options, juce::String& error)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        // Everything that is neither an option nor an option's value is an input
+        for (int i = 0; i < arguments.size(); ++i)
+        {
+            const auto& argument = arguments[i];
+
+            if (argument.isLongOption())
+            {
+                if (! argument.isLongOption("no-tail") && ! argument.text.contains("="))
+                    ++i;
+
+                continue;
+            }
+
+            collectInputs(argument.resolveAsFile(), formats, options.inputs);
+        }
+
+        options.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--output-dir"));
+
+        if (! arguments.containsOption("--output-dir") || ! options.outputDirectory.createDirectory())
+        {
+            error = "--output-dir must name a folder that exists or can be created";
+            return false;
+        }
+
+        for (const auto* stateOption : { "--state", "--preset" })
+        {
+            if (arguments.containsOption(stateOption))
+            {
+                const auto stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption(stateOption));
+
+                if (! loadState(stateFile, options.state, error))
+                    return false;
+            }
+        }
+
+        if (arguments.containsOption("--threads"))
+            options.numThreads = juce::jmax(1, arguments.getValueForOption("--threads").getIntValue());
+
+        if (arguments.containsOption("--block-size"))
+            options.blockSize = juce::jlimit(32, 65536, arguments.getValueForOption("--block-size").getIntValue());
+
+        if (arguments.containsOption("--format"))
+            options.format = arguments.getValueForOption("--format").toLowerCase();
+
+        if (arguments.containsOption("--suffix"))
+            options.suffix = arguments.getValueForOption("--suffix");
+
+        options.renderTail = ! arguments.containsOption("--no-tail");
+
+        if (options.inputs.isEmpty())
+        {
+            error = "no readable input files";
+            return false;
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+    juce::String error;
+
+    if (! parseOptions(juce::ArgumentList(argc, argv), options, error))
+    {
+        std::fprintf(stderr, "OfflineRender: %s\n", error.toRawUTF8());
+        return 1;
+    }
+
+    // Processors are built (and their state applied) here on the main thread;
+    // each worker then renders its share of the files independently
+    std::atomic<int> nextInput { 0 };
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+
+    for (int i = 0; i < juce::jmin(options.numThreads, options.inputs.size()); ++i)
+        workers.push_back(std::make_unique<RenderWorker>(options, nextInput, i));
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    int failures = 0;
+
+    for (auto& worker : workers)
+    {
+        worker->waitForThreadToExit(-1);
+        failures += worker->getNumFailures();
+    }
+
+    std::printf("%d of %d files rendered\n", options.inputs.size() - failures, options.inputs.size());
+    return failures == 0 ? 0 : 1;
+}
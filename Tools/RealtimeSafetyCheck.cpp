@@ -0,0 +1,173 @@
+// Real-time safety check: drives the whole parameter space through processBlock
+// and fails on any allocation or blocking lock on the audio thread.
+// Console app: build with the plugin sources (PluginProcessor, PluginEditor,
+// Components/, DSP/, LookAndFeel/), the same JUCE modules and JucePlugin_* defines,
+// plus PSAT_REALTIME_SAFETY_CHECKS=1; the CMake build does this and registers it
+// with CTest. It exits non-zero on the first build that introduces a violation.
+//
+//   RealtimeSafetyCheck [--random-states 200] [--seed 1]
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#if ! PSAT_REALTIME_SAFETY_CHECKS
+ #error "RealtimeSafetyCheck must be built with PSAT_REALTIME_SAFETY_CHECKS=1"
+#endif
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int maxBlockSize = 512;
+
+    // Odd and tiny sizes exercise the sub-block and partial-block paths
+    constexpr int blockSizes[] = { 512, 128, 1, 333 };
+
+    struct Setup
+    {
+        const char* name;
+        juce::AudioChannelSet channels;
+        bool parallel;
+    };
+
+    class Checker
+    {
+    public:
+        Checker(juce::AudioProcessor::ProcessingPrecision precisionToUse, const Setup& setupToUse, juce::int64 seed)
+            : precision(precisionToUse), setup(setupToUse), random(seed)
+        {
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(setup.channels);
+            layout.outputBuses.add(setup.channels);
+            processor.setBusesLayout(layout);
+            processor.setChannelParallelismEnabled(setup.parallel);
+            processor.setProcessingPrecision(precision);
+            processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+            processor.prepareToPlay(sampleRate, maxBlockSize);
+
+            const auto numChannels = setup.channels.size();
+            floatBuffer.setSize(numChannels, maxBlockSize);
+            doubleBuffer.setSize(numChannels, maxBlockSize);
+        }
+
+        ~Checker()
+        {
+            processor.releaseResources();
+        }
+
+        // Every parameter through its range, one at a time, from the defaults
+        void sweepParameters()
+        {
+            for (auto* parameter : processor.getParameters())
+            {
+                const auto numSteps = parameter->getNumSteps();
+                const auto discrete = parameter->isDiscrete() || parameter->isBoolean();
+                const auto numValues = discrete ? juce::jmin(numSteps, 16) : 5;
+
+                for (int step = 0; step < numValues; ++step)
+                {
+                    parameter->setValueNotifyingHost(static_cast<float>(step) / static_cast<float>(juce::jmax(1, numValues - 1)));
+                    run("parameter " + parameter->getName(64), false);
+                }
+
+                parameter->setValueNotifyingHost(parameter->getDefaultValue());
+            }
+        }
+
+        // Random combinations catch interactions the one-at-a-time sweep misses
+        void randomStates(int numStates)
+        {
+            for (int state = 0; state < numStates; ++state)
+            {
+                for (auto* parameter : processor.getParameters())
+                    parameter->setValueNotifyingHost(random.nextFloat());
+
+                run("random state " + juce::String(state), false);
+            }
+        }
+
+        // Bypass in and out (crossfade and warm-up), then the silent idle path
+        void bypassAndSilence()
+        {
+            run("bypass", true);
+            run("bypass release", false);
+
+            for (int block = 0; block < 200; ++block)
+                run("silence", false, true);
+
+            run("silence release", false);
+        }
+
+    private:
+        void run(const juce::String& what, bool bypassed, bool silent = false)
+        {
+            const auto before = RealtimeSafety::getNumViolations();
+
+            for (const auto blockSize : blockSizes)
+            {
+                if (precision == juce::AudioProcessor::doublePrecision)
+                    process(doubleBuffer, blockSize, bypassed, silent);
+                else
+                    process(floatBuffer, blockSize, bypassed, silent);
+            }
+
+            if (RealtimeSafety::getNumViolations() > before)
+                std::printf("  %s, %s: %d violation(s) during %s\n", setup.name,
+                            precision == juce::AudioProcessor::doublePrecision ? "double" : "float",
+                            RealtimeSafety::getNumViolations() - before, what.toRawUTF8());
+        }
+
+        template <typename SampleType>
+        void process(juce::AudioBuffer<SampleType>& buffer, int blockSize, bool bypassed, bool silent)
+        {
+            // Resizing within the allocated size keeps the host buffer itself allocation-free
+            buffer.setSize(buffer.getNumChannels(), blockSize, false, false, true);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                for (int sample = 0; sample < blockSize; ++sample)
+                    buffer.setSample(channel, sample, silent ? SampleType(0) : static_cast<SampleType>(random.nextFloat() - 0.5f));
+
+            if (bypassed)
+                processor.processBlockBypassed(buffer, midi);
+            else
+                processor.processBlock(buffer, midi);
+        }
+
+        juce::AudioProcessor::ProcessingPrecision precision;
+        const Setup& setup;
+        juce::Random random;
+        ProfessionalSaturationAudioProcessor processor;
+        juce::AudioBuffer<float> floatBuffer;
+        juce::AudioBuffer<double> doubleBuffer;
+        juce::MidiBuffer midi;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList arguments(argc, argv);
+    const auto numRandomStates = arguments.containsOption("--random-states") ? arguments.getValueForOption("--random-states").getIntValue() : 200;
+    const auto seed = arguments.containsOption("--seed") ? arguments.getValueForOption("--seed").getLargeIntValue() : 1;
+
+    const Setup setups[] = {
+        { "mono", juce::AudioChannelSet::mono(), false },
+        { "stereo", juce::AudioChannelSet::stereo(), false },
+        { "5.1 parallel", juce::AudioChannelSet::create5point1(), true }
+    };
+
+    for (const auto& setup : setups)
+    {
+        for (const auto precision : { juce::AudioProcessor::singlePrecision, juce::AudioProcessor::doublePrecision })
+        {
+            Checker checker(precision, setup, seed);
+            checker.sweepParameters();
+            checker.randomStates(numRandomStates);
+            checker.bypassAndSilence();
+        }
+    }
+
+    const auto violations = RealtimeSafety::getNumViolations();
+    std::printf("%d real-time safety violation(s)\n", violations);
+    return violations == 0 ? 0 : 1;
+}